@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# Runs STP with each multiplication variant on each input, and prints the
+# answer, the number of AIG nodes that were bit-blasted, and the seconds it
+# took. This is how the choices of --config_multiplication_variant=auto
+# were made.
+#
+# Usage: scripts/mult-variants.sh [-t secs] [-v "variants"] [files or dirs]
+# The default is to run every variant, for 60 seconds each, on
+# tests/crypto-tests and tests/sample-smt-tests.
+
+stp=bin/stp
+timeout=60
+variants="1 3 4 6 7 8 9 13 auto"
+
+while getopts "t:v:s:" opt
+do
+  case $opt in
+    t) timeout=$OPTARG ;;
+    v) variants=$OPTARG ;;
+    s) stp=$OPTARG ;;
+    *) echo "Usage: $0 [-t secs] [-v \"variants\"] [-s stp] [files or dirs]" 1>&2; exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+if [ $# == 0 ]
+then
+  set -- tests/crypto-tests tests/sample-smt-tests
+fi
+
+TIMEFORMAT=%R
+printf "%-45s %-8s %-8s %10s %8s\n" input variant answer aig seconds
+for input in $(find "$@" -type f \( -name "*.stp" -o -name "*.cvc" -o -name "*.smt" -o -name "*.smt2" \) | sort)
+do
+  for v in $variants
+  do
+    out=$( { time timeout $timeout $stp -s --config_multiplication_variant=$v $input 2>&1 ; } 2>&1 )
+    answer=$(echo "$out" | grep -E -m 1 "^(sat|unsat|Valid\.|Invalid\.)$")
+    aig=$(echo "$out" | grep -m 1 "Nodes before AIG rewrite:" | cut -d: -f2)
+    seconds=$(echo "$out" | tail -1)
+    printf "%-45s %-8s %-8s %10s %8s\n" $(basename $input) $v ${answer:-timeout} ${aig:--} $seconds
+  done
+done
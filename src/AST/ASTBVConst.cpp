@@ -39,8 +39,10 @@ namespace BEEV
   // unique table
   void ASTBVConst::CleanUp()
   {
-    (ParserBM)->_bvconst_unique_table.erase(this);
-    delete this;
+    STPMgr *bm = _bm;
+    bm->_bvconst_unique_table.erase(this);
+    this->~ASTBVConst();
+    bm->_bvconst_slab.release(this);
   } //End of Cleanup()
 
   // Print function for bvconst -- return _bvconst value in bin
@@ -51,7 +53,7 @@ namespace BEEV
     unsigned char *res;
     const char *prefix;
     
-    if((GlobalSTP->bm)->UserFlags.print_binary_flag) {
+    if(_bm->UserFlags.print_binary_flag) {
       res = CONSTANTBV::BitVector_to_Bin(_bvconst);
       if (c_friendly)
         {
@@ -19,8 +19,10 @@ namespace BEEV
   // the unique table
   void ASTInterior::CleanUp()
   {
-    (ParserBM)->_interior_unique_table.erase(this);
-    delete this;
+    STPMgr *bm = _bm;
+    bm->_interior_unique_table.erase(this);
+    this->~ASTInterior();
+    bm->_interior_slab.release(this);
   } //End of Cleanup()
 
   // Returns kinds.  "lispprinter" handles printing of parenthesis
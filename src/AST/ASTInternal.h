@@ -14,6 +14,8 @@
  ********************************************************************/
 namespace BEEV
 {
+  class STPMgr;
+
   /******************************************************************
    * struct enumeration:                                            *
    *                                                                *
@@ -49,6 +51,7 @@ namespace BEEV
   {
     friend class ASTNode;
     friend class CNFMgr;
+    friend class STPMgr;
 
   protected:
     /****************************************************************
@@ -88,6 +91,10 @@ namespace BEEV
      *******************************************************************/
     unsigned int  _value_width;
 
+    // The manager whose unique table holds this node. NULL for the
+    // temporary nodes used as hash keys.
+    STPMgr * _bm;
+
     /****************************************************************
      * Protected Member Functions                                   *
      ****************************************************************/
@@ -130,7 +137,7 @@ namespace BEEV
     ASTInternal(Kind kind, int nodenum = 0) :
       _ref_count(0), _kind(kind),
       _node_num(nodenum),
-      _index_width(0), _value_width(0), iteration(0)
+      _index_width(0), _value_width(0), _bm(NULL), iteration(0)
     {
     }
 
@@ -144,6 +151,7 @@ namespace BEEV
       _node_num(int_node._node_num), 
       _index_width(int_node._index_width),
       _value_width(int_node._value_width),
+      _bm(NULL),
       iteration(0)
     {
     }
@@ -128,7 +128,7 @@ namespace BEEV
 
   STPMgr* ASTNode::GetSTPMgr() const
   {
-    return ParserBM;
+    return _int_node_ptr->_bm;
   } //End of GetSTPMgr()
 
   // Checks if the node has alreadybeen printed or not
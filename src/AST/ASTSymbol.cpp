@@ -35,9 +35,11 @@ namespace BEEV
   // unique table
   void ASTSymbol::CleanUp()
   {
-    (ParserBM)->_symbol_unique_table.erase(this);
+    STPMgr *bm = _bm;
+    bm->_symbol_unique_table.erase(this);
     free((char*) this->_name);
-    delete this;
+    this->~ASTSymbol();
+    bm->_symbol_slab.release(this);
   }//End of cleanup()
 
   unsigned long long hash(unsigned char *str)
@@ -33,7 +33,7 @@ namespace BEEV
   //the function will then print the stats that it has collected.
   void CountersAndStats(const char * functionname, STPMgr * bm)
   {
-    static function_counters s;
+    function_counters& s = bm->functionCounters;
     if (bm->UserFlags.stats_flag)
       {
 
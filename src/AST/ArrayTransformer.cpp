@@ -61,9 +61,9 @@ namespace BEEV
 			 iset != iset_end; iset++)
 		  {
 				const ASTNode& ArrName = iset->first;
-				map<ASTNode, ArrayTransformer::ArrayRead>& mapper = iset->second;
+				ArrayTransformer::arrTypeMap& mapper = iset->second;
 
-				for (map<ASTNode, ArrayTransformer::ArrayRead>::iterator it =mapper.begin() ; it != mapper.end();it++)
+				for (ArrayTransformer::arrTypeMap::iterator it =mapper.begin() ; it != mapper.end();it++)
 				{
 					const ASTNode& the_index = it->first;
 
@@ -547,7 +547,7 @@ namespace BEEV
             ArrType::const_iterator it;
             if ((it = arrayToIndexToRead.find(arrName)) != arrayToIndexToRead.end())
               {
-                map<ASTNode, ArrayRead>::const_iterator it2;
+                arrTypeMap::const_iterator it2;
                   if ((it2 = it->second.find(readIndex)) != it->second.end())
                     {
                       result = it2->second.ite;
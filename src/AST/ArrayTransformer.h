@@ -11,6 +11,7 @@
 #define TRANSFORM_H
 
 #include "AST.h"
+#include "NodeAttribute.h"
 #include "../STPManager/STPManager.h"
 #include "../AST/NodeFactory/SimplifyingNodeFactory.h"
 #include "../boost/noncopyable.hpp"
@@ -50,8 +51,8 @@ namespace BEEV
       // a symbolic constant, say v1, and Read(A,j) is replaced with the
       // following ITE: ITE(i=j,v1,v2)
 
-      typedef map<ASTNode, ArrayRead> arrTypeMap;
-      typedef map<ASTNode, arrTypeMap > ArrType ;
+      typedef NodeAttribute<ArrayRead> arrTypeMap;
+      typedef NodeAttribute<arrTypeMap> ArrType;
       ArrType arrayToIndexToRead;
 
   private:
@@ -0,0 +1,202 @@
+// -*- c++ -*-
+/*
+ * A table from nodes to values, for memo tables that are hit on every
+ * node of a formula. Node numbers are unique within a manager, so most
+ * nodes are found by indexing an array with their node number rather than
+ * by hashing. A node whose number is far from the others goes in a small
+ * hash table instead, so a table with few entries stays small.
+ *
+ * It follows the parts of the std::map interface that the memo tables
+ * use. Entries are kept in insertion order, and references to the values
+ * stay valid until clear(). Like a map, it keeps its keys alive.
+ */
+#ifndef NODEATTRIBUTE_H
+#define NODEATTRIBUTE_H
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <utility>
+#include "UsefulDefs.h"
+#include "ASTNode.h"
+
+namespace BEEV
+{
+  template <class T>
+  class NodeAttribute
+  {
+  public:
+    typedef std::pair<ASTNode, T> value_type;
+    typedef typename std::deque<value_type>::iterator iterator;
+    typedef typename std::deque<value_type>::const_iterator const_iterator;
+
+  private:
+    std::deque<value_type> entries;
+
+    // One more than the position in "entries" of the node with number
+    // (base + i). Zero if the node isn't in the table.
+    std::vector<unsigned> dense;
+    unsigned base;
+
+    // For the nodes whose numbers are outside the dense range.
+    typedef HASHMAP<unsigned, unsigned> SparseMap;
+    SparseMap sparse;
+
+    // The dense range may have at most this many slots. A table that holds
+    // every node has about two slots per entry, because node numbers go up
+    // by two.
+    size_t denseLimit() const
+    {
+      return 16 * (entries.size() + 16);
+    }
+
+    unsigned position(const ASTNode& n) const
+    {
+      const unsigned num = n.GetNodeNum();
+      if (num - base < dense.size())
+        return dense[num - base];
+
+      if (sparse.empty())
+        return 0;
+      typename SparseMap::const_iterator it = sparse.find(num);
+      return (it == sparse.end()) ? 0 : it->second;
+    }
+
+    // Widens the dense range to include "num", unless it would get too big.
+    // The range at least doubles, so it is widened only a few times.
+    bool grow(const unsigned num)
+    {
+      const size_t limit = denseLimit();
+      size_t lo, hi;
+
+      if (dense.empty())
+        {
+          lo = num;
+          hi = (size_t) num + 64;
+        }
+      else if (num < base)
+        {
+          hi = base + dense.size();
+          if (hi - num > limit)
+            return false;
+          const size_t wanted = std::min(limit, std::max(hi - num, 2 * dense.size()));
+          lo = (hi >= wanted) ? hi - wanted : 0;
+        }
+      else
+        {
+          lo = base;
+          if ((size_t) num + 1 - lo > limit)
+            return false;
+          hi = lo + std::min(limit, std::max((size_t) num + 1 - lo, 2 * dense.size()));
+        }
+
+      std::vector<unsigned> wider(hi - lo, 0);
+      for (size_t i = 0; i < dense.size(); i++)
+        wider[base - lo + i] = dense[i];
+      dense.swap(wider);
+      base = lo;
+
+      // Move across the sparse entries that are now in range.
+      for (typename SparseMap::iterator it = sparse.begin(); it != sparse.end();)
+        if (it->first - base < dense.size())
+          {
+            dense[it->first - base] = it->second;
+            sparse.erase(it++);
+          }
+        else
+          it++;
+
+      return true;
+    }
+
+  public:
+    NodeAttribute() :
+      base(0)
+    {
+    }
+
+    iterator begin()
+    {
+      return entries.begin();
+    }
+
+    iterator end()
+    {
+      return entries.end();
+    }
+
+    const_iterator begin() const
+    {
+      return entries.begin();
+    }
+
+    const_iterator end() const
+    {
+      return entries.end();
+    }
+
+    size_t size() const
+    {
+      return entries.size();
+    }
+
+    bool empty() const
+    {
+      return entries.empty();
+    }
+
+    iterator find(const ASTNode& n)
+    {
+      const unsigned p = position(n);
+      return (p == 0) ? entries.end() : entries.begin() + (p - 1);
+    }
+
+    const_iterator find(const ASTNode& n) const
+    {
+      const unsigned p = position(n);
+      return (p == 0) ? entries.end() : entries.begin() + (p - 1);
+    }
+
+    // Doesn't replace the value if the node is already in the table.
+    std::pair<iterator, bool> insert(const value_type& v)
+    {
+      const unsigned p = position(v.first);
+      if (p != 0)
+        return std::make_pair(entries.begin() + (p - 1), false);
+
+      entries.push_back(v);
+      const unsigned num = v.first.GetNodeNum();
+      const unsigned pos = entries.size();
+      if (num - base < dense.size() || grow(num))
+        dense[num - base] = pos;
+      else
+        sparse[num] = pos;
+
+      return std::make_pair(entries.end() - 1, true);
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      for (; first != last; first++)
+        insert(*first);
+    }
+
+    T& operator[](const ASTNode& n)
+    {
+      const unsigned p = position(n);
+      if (p != 0)
+        return entries[p - 1].second;
+      return insert(value_type(n, T())).first->second;
+    }
+
+    void clear()
+    {
+      entries.clear();
+      std::vector<unsigned>().swap(dense);
+      base = 0;
+      sparse.clear();
+    }
+  };
+}
+#endif
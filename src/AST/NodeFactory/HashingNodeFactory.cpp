@@ -23,7 +23,9 @@ BEEV::ASTNode HashingNodeFactory::CreateNode(const Kind kind, const BEEV::ASTVec
               return back_children[0][0];
         }
 
-        ASTVec children(back_children);
+        // The scratch vector keeps its capacity, so this doesn't allocate
+        // unless a new node is made.
+        children.assign(back_children.begin(), back_children.end());
 	// The Bitvector solver seems to expect constants on the RHS, variables on the LHS.
 	// We leave the order of equals children as we find them.
 	if (BEEV::isCommutative(kind) && kind != BEEV::AND)
@@ -31,8 +33,8 @@ BEEV::ASTNode HashingNodeFactory::CreateNode(const Kind kind, const BEEV::ASTVec
 		SortByArith(children);
 	}
 
-        ASTInterior *n_ptr = new ASTInterior(kind,children);
-	ASTNode n(bm.LookupOrCreateInterior(n_ptr));
+	ASTNode n(bm.LookupOrCreateInterior(kind, children));
+	children.clear();
 	return n;
 }
 
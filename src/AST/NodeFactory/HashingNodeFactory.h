@@ -11,6 +11,9 @@ namespace BEEV
 
 class HashingNodeFactory : public NodeFactory
 {
+	// Scratch space for the children while looking up a node.
+	BEEV::ASTVec children;
+
 public:
 	HashingNodeFactory(BEEV::STPMgr& bm_)
 	:NodeFactory(bm_)
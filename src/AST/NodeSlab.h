@@ -0,0 +1,92 @@
+/*
+ * Hands out memory for objects of one type from large blocks. Released
+ * objects go on a free list to be reused. The blocks are only given back
+ * when the slab is destroyed, whether or not their objects were released.
+ */
+#ifndef NODESLAB_H
+#define NODESLAB_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "../boost/noncopyable.hpp"
+
+namespace BEEV
+{
+  template <class T>
+  class NodeSlab : boost::noncopyable
+  {
+    struct FreeSlot
+    {
+      FreeSlot* next;
+    };
+
+    // Each slot can hold either a T or a free list link.
+    enum
+    {
+      slot_align = __alignof__(T) > __alignof__(FreeSlot) ? __alignof__(T) : __alignof__(FreeSlot),
+      slot_bytes = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot),
+      slot_size = (slot_bytes + slot_align - 1) / slot_align * slot_align
+    };
+
+    // Blocks double in size up to the maximum, so small problems stay small.
+    enum
+    {
+      first_block = 64, max_block = 16 * 1024
+    };
+
+    std::vector<char*> blocks;
+    char* next;
+    char* end;
+    size_t block_slots;
+    FreeSlot* free_list;
+
+  public:
+    NodeSlab() :
+      next(NULL), end(NULL), block_slots(first_block), free_list(NULL)
+    {
+    }
+
+    ~NodeSlab()
+    {
+      for (size_t i = 0; i < blocks.size(); i++)
+        free(blocks[i]);
+    }
+
+    // Memory for one T, which the caller constructs with placement new.
+    void* allocate()
+    {
+      if (free_list != NULL)
+        {
+          FreeSlot* s = free_list;
+          free_list = s->next;
+          return s;
+        }
+
+      if (next == end)
+        {
+          char* b = (char*) malloc(block_slots * slot_size);
+          if (b == NULL)
+            throw std::bad_alloc();
+          blocks.push_back(b);
+          next = b;
+          end = b + block_slots * slot_size;
+          if (block_slots < max_block)
+            block_slots *= 2;
+        }
+
+      void* result = next;
+      next += slot_size;
+      return result;
+    }
+
+    // Takes back memory from allocate(). The T in it must already be destroyed.
+    void release(void* p)
+    {
+      FreeSlot* s = (FreeSlot*) p;
+      s->next = free_list;
+      free_list = s;
+    }
+  };
+}
+#endif
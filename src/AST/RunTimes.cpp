@@ -16,7 +16,7 @@
 #include "../sat/utils/System.h"
 
 // BE VERY CAREFUL> Update the Category Names to match.
-std::string RunTimes::CategoryNames[] = { "Transforming", "Simplifying", "Parsing", "CNF Conversion", "Bit Blasting", "SAT Solving", "Bitvector Solving","Variable Elimination", "Sending to SAT Solver", "Counter Example Generation","SAT Simplification", "Constant Bit Propagation","Array Read Refinement", "Applying Substitutions", "Removing Unconstrained", "Pure Literals" , "ITE Contexts", "AIG core simplification", "Interval Propagation", "Always True"};
+std::string RunTimes::CategoryNames[] = { "Transforming", "Simplifying", "Parsing", "CNF Conversion", "Bit Blasting", "SAT Solving", "Bitvector Solving","Variable Elimination", "Sending to SAT Solver", "Counter Example Generation","SAT Simplification", "Constant Bit Propagation","Array Read Refinement", "Applying Substitutions", "Removing Unconstrained", "Pure Literals" , "ITE Contexts", "AIG core simplification", "Interval Propagation", "Always True", "Random Simulation", "Solved by Random Simulation", "Query Cache Hits", "Query Cache Misses", "Solved by Last Model", "Multiplication and Division Refinement"};
 
 namespace BEEV
 {
@@ -52,6 +52,8 @@ void RunTimes::print()
   		int time_ms = 0;
   		if ((it2 = times.find(it1->first)) != times.end())
   			time_ms = it2->second;
+  		else // Only counted, e.g. how many times something worked.
+  			result << " " << CategoryNames[it1->first] << ": " << it1->second << std::endl;
 
   		if (time_ms!=0)
   		{
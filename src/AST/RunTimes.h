@@ -41,7 +41,13 @@ public:
       UseITEContext,
       AIGSimplifyCore,
       IntervalPropagation,
-      AlwaysTrue
+      AlwaysTrue,
+      RandomSimulation,
+      SolvedByRandomSimulation,
+      QueryCacheHits,
+      QueryCacheMisses,
+      SolvedByLastModel,
+      MultDivRefinement
     };
 
   static std::string CategoryNames[];
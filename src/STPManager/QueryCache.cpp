@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "QueryCache.h"
+
+namespace BEEV
+{
+  // It's only a cache, so when it gets this big it's started again.
+  static const unsigned maxEntries = 10000;
+  static const unsigned maxHashes = 1 << 21;
+
+  // The finaliser of splitmix64.
+  static QueryCache::Hash mix(QueryCache::Hash h)
+  {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  static QueryCache::Hash combine(QueryCache::Hash h, QueryCache::Hash v)
+  {
+    return (h * 0x9e3779b97f4a7c15ULL) ^ mix(v);
+  }
+
+  static QueryCache::Hash hashString(const char* s)
+  {
+    QueryCache::Hash h = 0xcbf29ce484222325ULL;
+    for (; *s != '\0'; s++)
+      h = (h ^ (unsigned char) *s) * 0x100000001b3ULL;
+    return h;
+  }
+
+  // The hash of a sorted set of hashes.
+  static QueryCache::Hash setHash(const vector<QueryCache::Hash>& hashes)
+  {
+    QueryCache::Hash h = hashes.size();
+    for (unsigned i = 0; i < hashes.size(); i++)
+      h = combine(h, hashes[i]);
+    return h;
+  }
+
+  QueryCache::Hash QueryCache::hash(const ASTNode& n)
+  {
+    NodeAttribute<Hash>::const_iterator it = hashes.find(n);
+    if (it != hashes.end())
+      return it->second;
+
+    const Kind k = n.GetKind();
+    const unsigned width = n.GetValueWidth();
+    Hash h = combine(combine(k + 1, width), n.GetIndexWidth());
+
+    if (SYMBOL == k)
+      h = combine(h, hashString(n.GetName()));
+    else if (BVCONST == k)
+      {
+        CBV c = n.GetBVConst();
+        for (unsigned i = 0; i < width; i += 32)
+          h = combine(h, CONSTANTBV::BitVector_Chunk_Read(c, std::min(32u, width - i), i));
+      }
+    else
+      {
+        vector<Hash> children;
+        children.reserve(n.Degree());
+        for (ASTVec::const_iterator c = n.begin(); c != n.end(); c++)
+          children.push_back(hash(*c));
+        if (isCommutative(k))
+          sort(children.begin(), children.end());
+        for (unsigned i = 0; i < children.size(); i++)
+          h = combine(h, children[i]);
+      }
+
+    hashes.insert(make_pair(n, h));
+    return h;
+  }
+
+  QueryCache::Key QueryCache::key(const ASTNodeSet& conjuncts)
+  {
+    if (hashes.size() > maxHashes)
+      hashes.clear();
+
+    // The answer can depend on the flags that change what operations mean.
+    const Hash seed = bm->UserFlags.division_by_zero_returns_one_flag ? 1 : 0;
+
+    Key k;
+    for (ASTNodeSet::const_iterator it = conjuncts.begin(); it != conjuncts.end(); it++)
+      k.conjuncts.push_back(combine(hash(*it), seed));
+    sort(k.conjuncts.begin(), k.conjuncts.end());
+    k.conjuncts.erase(unique(k.conjuncts.begin(), k.conjuncts.end()), k.conjuncts.end());
+
+    k.hash = setHash(k.conjuncts);
+    return k;
+  }
+
+  void QueryCache::add(const Entry& e)
+  {
+    if (entries.size() >= maxEntries)
+      {
+        entries.clear();
+        exact.clear();
+        containing.clear();
+      }
+
+    const Hash h = setHash(e.conjuncts);
+    if (exact.find(h) != exact.end())
+      return;
+
+    const unsigned index = entries.size();
+    entries.push_back(e);
+    exact[h] = index;
+    for (unsigned i = 0; i < e.conjuncts.size(); i++)
+      containing[e.conjuncts[i]].push_back(index);
+  }
+
+  // Each line is an entry: "u" or "s", the number of conjuncts and their
+  // hashes, then for a satisfiable entry the number of values, and each
+  // value as its width, its bits, and its name's length and name.
+  void QueryCache::load(const string& fileName)
+  {
+    std::ifstream in(fileName.c_str());
+    string line;
+    while (getline(in, line))
+      {
+        std::istringstream s(line);
+        string kind;
+        unsigned count;
+        if (!(s >> kind >> count) || (kind != "u" && kind != "s"))
+          continue;
+
+        Entry e;
+        e.satisfiable = (kind == "s");
+        e.hasModel = false;
+        e.conjuncts.resize(count);
+        for (unsigned i = 0; i < count; i++)
+          s >> std::hex >> e.conjuncts[i] >> std::dec;
+
+        if (e.satisfiable && s >> count)
+          {
+            e.hasModel = true;
+            e.model.resize(count);
+            for (unsigned i = 0; i < count; i++)
+              {
+                Value& v = e.model[i];
+                unsigned length;
+                char colon;
+                s >> v.width >> v.bits >> length;
+                s.get(colon);
+                vector<char> name(length + 1);
+                s.read(&name[0], length);
+                v.name.assign(&name[0], length);
+              }
+          }
+
+        if (s.fail())
+          continue;
+        sort(e.conjuncts.begin(), e.conjuncts.end());
+        add(e);
+      }
+  }
+
+  void QueryCache::save(const string& fileName, const Entry& e) const
+  {
+    std::ofstream out(fileName.c_str(), std::ios::app);
+    out << (e.satisfiable ? "s" : "u") << " " << e.conjuncts.size() << std::hex;
+    for (unsigned i = 0; i < e.conjuncts.size(); i++)
+      out << " " << e.conjuncts[i];
+    out << std::dec;
+
+    if (e.hasModel)
+      {
+        out << " " << e.model.size();
+        for (unsigned i = 0; i < e.model.size(); i++)
+          {
+            const Value& v = e.model[i];
+            out << " " << v.width << " " << v.bits << " " << v.name.size() << ":" << v.name;
+          }
+      }
+    out << "\n";
+  }
+
+  // Sets the counterexample from the model of "e", if it satisfies "input".
+  bool QueryCache::reuseModel(const Entry& e, const ASTNode& input, AbsRefine_CounterExample* ce,
+                              VariablesInExpression& vars)
+  {
+    if (!bm->UserFlags.construct_counterexample_flag)
+      return true;
+    if (!e.hasModel)
+      return false;
+
+    bool destruct;
+    ASTNodeSet* symbols = vars.SetofVarsSeenInTerm(input, destruct);
+
+    ASTNodeMap model;
+    for (unsigned i = 0; i < e.model.size(); i++)
+      {
+        const Value& v = e.model[i];
+        ASTNode symbol;
+        if (!bm->LookupSymbol(v.name.c_str(), symbol) || symbols->find(symbol) == symbols->end())
+          continue;
+
+        if (0 == v.width && BOOLEAN_TYPE == symbol.GetType())
+          model[symbol] = bm->CreateNode(v.bits == "1" ? TRUE : FALSE);
+        else if (v.width == symbol.GetValueWidth() && BITVECTOR_TYPE == symbol.GetType())
+          model[symbol] = bm->CreateBVConst(v.bits, 2, v.width);
+      }
+
+    if (destruct)
+      delete symbols;
+
+    return ce->TrySetCounterExample(model, input);
+  }
+
+  SOLVER_RETURN_TYPE QueryCache::lookup(const Key& k, const ASTNode& input, AbsRefine_CounterExample* ce,
+                                        VariablesInExpression& vars)
+  {
+    if (!loaded)
+      {
+        loaded = true;
+        const string fileName = bm->UserFlags.get("query-cache-file", "");
+        if (fileName != "")
+          load(fileName);
+      }
+
+    SOLVER_RETURN_TYPE result = SOLVER_UNDECIDED;
+
+    HASHMAP<Hash, unsigned>::const_iterator it = exact.find(k.hash);
+    if (it != exact.end() && entries[it->second].conjuncts == k.conjuncts)
+      {
+        const Entry& e = entries[it->second];
+        if (!e.satisfiable)
+          result = SOLVER_VALID;
+        else if (reuseModel(e, input, ce, vars))
+          result = SOLVER_INVALID;
+      }
+
+    // How many of the conjuncts each entry shares with the input.
+    HASHMAP<unsigned, unsigned> shared;
+    if (result == SOLVER_UNDECIDED)
+      for (unsigned i = 0; i < k.conjuncts.size(); i++)
+        {
+          HASHMAP<Hash, vector<unsigned> >::const_iterator c = containing.find(k.conjuncts[i]);
+          if (c != containing.end())
+            for (unsigned j = 0; j < c->second.size(); j++)
+              shared[c->second[j]]++;
+        }
+
+    // An unsatisfiable subset.
+    for (HASHMAP<unsigned, unsigned>::const_iterator s = shared.begin(); s != shared.end()
+        && result == SOLVER_UNDECIDED; s++)
+      {
+        const Entry& e = entries[s->first];
+        if (!e.satisfiable && s->second == e.conjuncts.size())
+          result = SOLVER_VALID;
+      }
+
+    // A satisfiable superset.
+    for (HASHMAP<unsigned, unsigned>::const_iterator s = shared.begin(); s != shared.end()
+        && result == SOLVER_UNDECIDED; s++)
+      {
+        const Entry& e = entries[s->first];
+        if (e.satisfiable && s->second == k.conjuncts.size() && reuseModel(e, input, ce, vars))
+          result = SOLVER_INVALID;
+      }
+
+    bm->GetRunTimes()->addCount(result == SOLVER_UNDECIDED ? RunTimes::QueryCacheMisses : RunTimes::QueryCacheHits);
+    return result;
+  }
+
+  void QueryCache::store(const Key& k, const ASTNode& input, SOLVER_RETURN_TYPE result,
+                         AbsRefine_CounterExample* ce, VariablesInExpression& vars)
+  {
+    if ((result != SOLVER_VALID && result != SOLVER_INVALID) || bm->soft_timeout_expired)
+      return;
+
+    HASHMAP<Hash, unsigned>::const_iterator it = exact.find(k.hash);
+    if (it != exact.end() && entries[it->second].conjuncts == k.conjuncts)
+      return;
+
+    Entry e;
+    e.conjuncts = k.conjuncts;
+    e.satisfiable = (result == SOLVER_INVALID);
+    e.hasModel = e.satisfiable && bm->UserFlags.construct_counterexample_flag;
+
+    if (e.hasModel)
+      {
+        bool destruct;
+        ASTNodeSet* symbols = vars.SetofVarsSeenInTerm(input, destruct);
+        ASTNodeMap values;
+        ce->GetCounterExampleValues(ASTVec(symbols->begin(), symbols->end()), values);
+        if (destruct)
+          delete symbols;
+
+        for (ASTNodeMap::const_iterator v = values.begin(); v != values.end(); v++)
+          {
+            Value value;
+            value.name = v->first.GetName();
+            if (BVCONST == v->second.GetKind())
+              {
+                value.width = v->second.GetValueWidth();
+                unsigned char* bits = CONSTANTBV::BitVector_to_Bin(v->second.GetBVConst());
+                value.bits = (char*) bits;
+                CONSTANTBV::BitVector_Dispose(bits);
+              }
+            else if (v->second.GetType() == BOOLEAN_TYPE && v->second.isConstant())
+              {
+                value.width = 0;
+                value.bits = (TRUE == v->second.GetKind()) ? "1" : "0";
+              }
+            else
+              continue;
+            e.model.push_back(value);
+          }
+      }
+
+    add(e);
+
+    const string fileName = bm->UserFlags.get("query-cache-file", "");
+    if (fileName != "")
+      save(fileName, e);
+  }
+}
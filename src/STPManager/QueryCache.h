@@ -0,0 +1,95 @@
+// -*- c++ -*-
+/*
+ * Remembers the answers to earlier inputs, so that a program that asks the
+ * same or similar questions again, like a symbolic executor, doesn't solve
+ * them again. An input is kept as the set of the structural hashes of its
+ * conjuncts. The hashes depend on the kinds, widths, symbol names and
+ * constants, but not on node numbers, so they are the same in a different
+ * process and the cache can be kept in a file.
+ *
+ * Besides the same input, an unsatisfiable subset of the conjuncts shows
+ * that an input is unsatisfiable, and the model of a satisfiable superset
+ * satisfies it. Models are checked against the input before they're used.
+ */
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include "../AST/AST.h"
+#include "../AST/NodeAttribute.h"
+#include "STPManager.h"
+#include "../absrefine_counterexample/AbsRefine_CounterExample.h"
+#include "../simplifier/VariablesInExpression.h"
+#include "../boost/noncopyable.hpp"
+
+namespace BEEV
+{
+  class QueryCache : boost::noncopyable
+  {
+  public:
+    typedef uint64_t Hash;
+
+    // The sorted hashes of the conjuncts of an input.
+    struct Key
+    {
+      vector<Hash> conjuncts;
+      Hash hash;
+    };
+
+  private:
+    // The value of a symbol, by name, so that it can be written out.
+    struct Value
+    {
+      string name;
+      unsigned width; // Zero for booleans.
+      string bits;    // Most significant first.
+    };
+
+    struct Entry
+    {
+      vector<Hash> conjuncts;
+      bool satisfiable;
+      bool hasModel;
+      vector<Value> model;
+    };
+
+    STPMgr* bm;
+    vector<Entry> entries;
+
+    // From a key's hash to its entry, and from a conjunct's hash to the
+    // entries that contain it.
+    HASHMAP<Hash, unsigned> exact;
+    HASHMAP<Hash, vector<unsigned> > containing;
+
+    NodeAttribute<Hash> hashes;
+
+    bool loaded;
+
+    Hash hash(const ASTNode& n);
+    void add(const Entry& e);
+    void load(const string& fileName);
+    void save(const string& fileName, const Entry& e) const;
+    bool reuseModel(const Entry& e, const ASTNode& input, AbsRefine_CounterExample* ce,
+                    VariablesInExpression& vars);
+
+  public:
+    QueryCache(STPMgr* b) :
+      bm(b), loaded(false)
+    {
+    }
+
+    Key key(const ASTNodeSet& conjuncts);
+
+    // Returns the answer for "input" if it follows from what's cached, and
+    // sets the counterexample if it's satisfiable. Otherwise returns
+    // SOLVER_UNDECIDED.
+    SOLVER_RETURN_TYPE lookup(const Key& k, const ASTNode& input, AbsRefine_CounterExample* ce,
+                              VariablesInExpression& vars);
+
+    // Remembers the answer for "input", with the counterexample if it's
+    // satisfiable.
+    void store(const Key& k, const ASTNode& input, SOLVER_RETURN_TYPE result, AbsRefine_CounterExample* ce,
+               VariablesInExpression& vars);
+  };
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include "STP.h"
 #include "DifficultyScore.h"
 #include "../to-sat/AIG/ToSATAIG.h"
+#include "../to-sat/AIG/ToSATAIGIncremental.h"
 #include "../simplifier/constantBitP/ConstantBitPropagation.h"
 #include "../simplifier/constantBitP/NodeToFixedBitsMap.h"
 #include "../sat/SimplifyingMinisat.h"
@@ -17,6 +18,7 @@
 #include "../sat/CryptoMinisat.h"
 #include "../sat/MinisatCore_prop.h"
 #include "../sat/core_prop/Solver_prop.h"
+#include "../sat/PortfolioSolver.h"
 #include "../simplifier/RemoveUnconstrained.h"
 #include "../simplifier/FindPureLiterals.h"
 #include "../simplifier/EstablishIntervals.h"
@@ -37,16 +39,382 @@ namespace BEEV {
   const  static string pe_message=       "After Propagating Equalities. ";
 
 
+  STP::~STP()
+  {
+    ClearAllTables();
+    delete Ctr_Example;
+    Ctr_Example = NULL;
+    delete arrayTransformer;
+    arrayTransformer = NULL;
+    delete tosat;
+    tosat = NULL;
+    delete simp;
+    simp = NULL;
+    delete incrementalToSAT;
+    incrementalToSAT = NULL;
+    delete incrementalSolver;
+    incrementalSolver = NULL;
+    //delete bm;
+  }
+
+  // The solver stops when "interrupt" is set.
+  static SATSolver* newSolver(UserDefinedFlags::SATSolvers solver, volatile bool& interrupt)
+  {
+    SATSolver *newS = NULL;
+    if (solver == UserDefinedFlags::SIMPLIFYING_MINISAT_SOLVER)
+		newS = new SimplifyingMinisat(interrupt);
+    else if (solver == UserDefinedFlags::CRYPTOMINISAT_SOLVER)
+                    newS = new CryptoMinisat(interrupt);
+    else if (solver == UserDefinedFlags::MINISAT_SOLVER)
+      newS = new MinisatCore<Minisat::Solver>(interrupt);
+    else if (solver == UserDefinedFlags::MINISAT_PROPAGATORS)
+      newS = new MinisatCore_prop<Minisat::Solver_prop>(interrupt);
+    return newS;
+  }
+
+  SATSolver* STP::createSolver()
+  {
+    SATSolver *newS;
+    const int size = bm->UserFlags.portfolio_size;
+    if (size > 1)
+      {
+        // The user's choice of solver goes first, then the others in turn.
+        // Once each kind has had a go, they repeat with different seeds.
+        const int kinds = UserDefinedFlags::MINISAT_PROPAGATORS + 1;
+        PortfolioSolver* portfolio = new PortfolioSolver(bm->soft_timeout_expired, size);
+        for (int i = 0; i < size; i++)
+          {
+            UserDefinedFlags::SATSolvers solver = (UserDefinedFlags::SATSolvers) ((bm->UserFlags.solver_to_use + i) % kinds);
+            SATSolver* s = newSolver(solver, portfolio->stopFlag(i));
+            if (i >= kinds)
+              s->setSeed(i);
+            portfolio->setSolver(i, s, solver == UserDefinedFlags::MINISAT_PROPAGATORS);
+          }
+        newS = portfolio;
+      }
+    else
+      newS = newSolver(bm->UserFlags.solver_to_use, bm->soft_timeout_expired);
+
+    if(bm->UserFlags.stats_flag)
+      {
+	newS->setVerbosity(1);
+      }
+    
+    if(bm->UserFlags.random_seed_flag)
+      {
+        newS->setSeed(bm->UserFlags.random_seed);
+      }
+
+    return newS;
+  }
+
+  // Collects the conjuncts of n, ignoring TRUE.
+  static void flattenConjuncts(const ASTNode& n, ASTNodeSet& result)
+  {
+    if (n.GetKind() == AND)
+      {
+        for (int i = 0; i < n.Degree(); i++)
+          flattenConjuncts(n[i], result);
+      }
+    else if (n.GetKind() != TRUE)
+      result.insert(n);
+  }
+
+  bool STP::assertsAreLevels(const ASTNode& inputasserts, vector<ASTNodeSet>& levels)
+  {
+    ASTNodeSet asked;
+    flattenConjuncts(inputasserts, asked);
+
+    ASTNodeSet asserted;
+    levels.resize(bm->getAssertLevel());
+    for (int i = 0; i < levels.size(); i++)
+      {
+        const ASTVec& v = bm->getAssertsAtLevel(i);
+        for (int j = 0; j < v.size(); j++)
+          flattenConjuncts(v[j], levels[i]);
+        asserted.insert(levels[i].begin(), levels[i].end());
+      }
+
+    if (asked.size() != asserted.size())
+      return false;
+
+    for (ASTNodeSet::const_iterator it = asked.begin(); it != asked.end(); it++)
+      if (asserted.find(*it) == asserted.end())
+        return false;
+
+    return true;
+  }
+
+  SOLVER_RETURN_TYPE STP::TopLevelSTPIncremental(const vector<ASTNodeSet>& levels,
+                                                 const ASTNode& query,
+                                                 const ASTNode& original_input)
+  {
+    // The tables of the normal pipeline are used to build the counterexample.
+    ClearAllTables();
+
+    if (incrementalSolver == NULL)
+      {
+        incrementalSolver = createSolver();
+        incrementalToSAT = new ToSATAIGIncremental(bm);
+      }
+    SATSolver& satSolver = *incrementalSolver;
+
+    // If some of what was encoded for a level has gone, then the level was popped.
+    // It and all the levels above it are disabled for good.
+    int keep = 0;
+    while (keep < activationLevels.size() && keep < levels.size())
+      {
+        const ASTNodeSet& encoded = activationLevels[keep].encoded;
+        bool popped = false;
+        for (ASTNodeSet::const_iterator it = encoded.begin(); it != encoded.end() && !popped; it++)
+          popped = (levels[keep].find(*it) == levels[keep].end());
+        if (popped)
+          break;
+        keep++;
+      }
+
+    for (int i = keep; i < activationLevels.size(); i++)
+      incrementalToSAT->retire(satSolver, activationLevels[i].activation);
+    activationLevels.resize(keep);
+
+    // Send the new assertions of each level, guarded by the level's literal.
+    vector<SATSolver::Var> assumptions;
+    for (int i = 0; i < levels.size(); i++)
+      {
+        if (i == activationLevels.size())
+          {
+            activationLevels.push_back(ActivationLevel());
+            activationLevels.back().activation = incrementalToSAT->newActivation(satSolver);
+          }
+        ActivationLevel& level = activationLevels[i];
+
+        ASTVec toAdd;
+        for (ASTNodeSet::const_iterator it = levels[i].begin(); it != levels[i].end(); it++)
+          if (level.encoded.insert(*it).second)
+            toAdd.push_back(*it);
+
+        if (toAdd.size() == 1)
+          incrementalToSAT->addGuarded(satSolver, toAdd[0], level.activation);
+        else if (toAdd.size() > 1)
+          incrementalToSAT->addGuarded(satSolver, bm->CreateNode(AND, toAdd), level.activation);
+
+        assumptions.push_back(level.activation);
+      }
+    incrementalToSAT->setAssumptions(assumptions);
+
+    const ASTNode negatedQuery = (query == bm->ASTFalse) ? bm->ASTTrue : bm->CreateNode(NOT, query);
+    SOLVER_RETURN_TYPE res = Ctr_Example->CallSAT_ResultCheck(satSolver, negatedQuery, original_input, incrementalToSAT, false);
+
+    if (SOLVER_UNDECIDED == res)
+      FatalError("TopLevelSTPIncremental: the model doesn't satisfy the input:"
+        "either a divide by zero in the input or a bug in STP");
+
+    if (!bm->soft_timeout_expired)
+      CountersAndStats("print_func_stats", bm);
+
+    return res;
+  }
+
+  typedef hash_map<Symbols*, int, SymbolPtrHasher> SymbolsToConjunct;
+
+  static int findPart(vector<int>& parent, int i)
+  {
+    while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+    return i;
+  }
+
+  // Puts conjunct "i" in the same part as the conjuncts that have already
+  // reached the variables below "s".
+  static void joinParts(Symbols* s, int i, SymbolsToConjunct& reached, vector<int>& parent,
+                        vector<pair<ASTNode, int> >& variables)
+  {
+    SymbolsToConjunct::const_iterator it = reached.find(s);
+    if (it != reached.end())
+      {
+        parent[findPart(parent, it->second)] = findPart(parent, i);
+        return;
+      }
+    reached.insert(make_pair(s, i));
+
+    if (s->isLeaf())
+      variables.push_back(make_pair(s->found, i));
+
+    for (int j = 0; j < s->children.size(); j++)
+      joinParts(s->children[j], i, reached, parent, variables);
+  }
+
+  // Groups the conjuncts of "input" into parts that share no variables.
+  // "symbols" gets the variables of each part.
+  static void independentParts(const ASTNode& input, VariablesInExpression& vars,
+                               vector<ASTVec>& parts, vector<ASTVec>& symbols)
+  {
+    ASTNodeSet conjunctSet;
+    flattenConjuncts(input, conjunctSet);
+
+    // Sorted, so the same conjuncts always give the same parts.
+    ASTVec conjuncts(conjunctSet.begin(), conjunctSet.end());
+    sort(conjuncts.begin(), conjuncts.end());
+
+    vector<int> parent(conjuncts.size());
+    SymbolsToConjunct reached;
+    vector<pair<ASTNode, int> > variables;
+    for (int i = 0; i < conjuncts.size(); i++)
+      {
+        parent[i] = i;
+        joinParts(vars.getSymbol(conjuncts[i]), i, reached, parent, variables);
+      }
+
+    vector<int> partOf(conjuncts.size(), -1);
+    for (int i = 0; i < conjuncts.size(); i++)
+      {
+        const int root = findPart(parent, i);
+        if (partOf[root] == -1)
+          {
+            partOf[root] = parts.size();
+            parts.push_back(ASTVec());
+            symbols.push_back(ASTVec());
+          }
+        parts[partOf[root]].push_back(conjuncts[i]);
+      }
+
+    for (int i = 0; i < variables.size(); i++)
+      symbols[partOf[findPart(parent, variables[i].second)]].push_back(variables[i].first);
+  }
+
+  SOLVER_RETURN_TYPE STP::TopLevelSTPSliced(const ASTNode& original_input)
+  {
+    vector<ASTVec> parts, symbols;
+    independentParts(original_input, simp->getVariablesInExpression(), parts, symbols);
+    if (parts.empty())
+      return solveWithNewSolver(original_input);
+
+    // The parts already known to be satisfiable contribute just their model.
+    ASTNodeMap model;
+    ASTVec toSolve;
+    vector<int> solving;
+    for (int i = 0; i < parts.size(); i++)
+      {
+        const ASTNode part = (parts[i].size() == 1) ? parts[i][0] : bm->CreateNode(AND, parts[i]);
+        PartToModel::const_iterator it = satisfiableParts.find(part);
+        if (it == satisfiableParts.end())
+          {
+            toSolve.push_back(part);
+            solving.push_back(i);
+          }
+        else
+          model.insert(it->second.begin(), it->second.end());
+      }
+
+    const bool independently = bm->UserFlags.isSet("slice-independently", "0") && toSolve.size() > 1;
+    const bool merging = independently || toSolve.size() < parts.size();
+
+    // The model of a part doesn't satisfy the whole input, so it's checked
+    // and printed once the parts are merged.
+    const bool check = bm->UserFlags.check_counterexample_flag;
+    const bool print = bm->UserFlags.print_counterexample_flag;
+    if (merging)
+      {
+        bm->UserFlags.check_counterexample_flag = false;
+        bm->UserFlags.print_counterexample_flag = false;
+      }
+
+    SOLVER_RETURN_TYPE result = SOLVER_INVALID;
+    int solved = 0;
+    while (solved < toSolve.size() && result == SOLVER_INVALID)
+      {
+        const int end = independently ? solved + 1 : toSolve.size();
+        ASTVec input(toSolve.begin() + solved, toSolve.begin() + end);
+        result = solveWithNewSolver((input.size() == 1) ? input[0] : bm->CreateNode(AND, input));
+        if (result != SOLVER_INVALID)
+          break;
+
+        for (; solved < end; solved++)
+          {
+            ASTNodeMap values;
+            Ctr_Example->GetCounterExampleValues(symbols[solving[solved]], values);
+            model.insert(values.begin(), values.end());
+
+            // It's only a cache, so when it gets big it's started again.
+            if (satisfiableParts.size() >= 10000)
+              satisfiableParts.clear();
+            satisfiableParts[toSolve[solved]] = values;
+          }
+      }
+
+    bm->UserFlags.check_counterexample_flag = check;
+    bm->UserFlags.print_counterexample_flag = print;
+
+    if (merging && result == SOLVER_INVALID)
+      Ctr_Example->SetCounterExample(model);
+
+    return result;
+  }
+
+  SOLVER_RETURN_TYPE STP::solveWithNewSolver(const ASTNode& input)
+  {
+    // Unfortunatey this is a global variable,which the aux function needs to overwrite sometimes.
+    bool saved_ack = bm->UserFlags.ackermannisation;
+
+    SATSolver *newS = createSolver();
+    SATSolver& NewSolver = *newS;
+
+    SOLVER_RETURN_TYPE result;
+    result = TopLevelSTPAux(NewSolver,
+                              input);
+
+    delete newS;
+
+    bm->UserFlags.ackermannisation =saved_ack;
+    return result;
+  }
+
+  bool STP::tryLastModel(const ASTNode& input)
+  {
+    if (lastModel.empty())
+      return false;
+
+    bool destruct;
+    ASTNodeSet* symbols = simp->getVariablesInExpression().SetofVarsSeenInTerm(input, destruct);
+    ASTNodeMap model;
+    for (ASTNodeSet::const_iterator it = symbols->begin(); it != symbols->end(); it++)
+      {
+        ASTNodeMap::const_iterator v = lastModel.find(*it);
+        if (v != lastModel.end())
+          model.insert(*v);
+      }
+    if (destruct)
+      delete symbols;
+
+    if (!Ctr_Example->TrySetCounterExample(model, input))
+      return false;
+
+    bm->GetRunTimes()->addCount(RunTimes::SolvedByLastModel);
+    return true;
+  }
+
+  void STP::rememberModel(const ASTNode& input)
+  {
+    bool destruct;
+    ASTNodeSet* symbols = simp->getVariablesInExpression().SetofVarsSeenInTerm(input, destruct);
+    ASTNodeMap values;
+    Ctr_Example->GetCounterExampleValues(ASTVec(symbols->begin(), symbols->end()), values);
+    if (destruct)
+      delete symbols;
+
+    // The values of the symbols that weren't in this input are kept.
+    for (ASTNodeMap::const_iterator it = values.begin(); it != values.end(); it++)
+      lastModel[it->first] = it->second;
+  }
 
    // The absolute TopLevel function that invokes STP on the input
     // formula
   SOLVER_RETURN_TYPE STP::TopLevelSTP(const ASTNode& inputasserts, 
 				      const ASTNode& query)
   {      
-
-    // Unfortunatey this is a global variable,which the aux function needs to overwrite sometimes.
-    bool saved_ack = bm->UserFlags.ackermannisation;
-
     ASTNode original_input;
 
     if (query != bm->ASTFalse)
@@ -56,49 +424,64 @@ namespace BEEV {
     else
       original_input = inputasserts;
 
-    SATSolver *newS;
-    if (bm->UserFlags.solver_to_use == UserDefinedFlags::SIMPLIFYING_MINISAT_SOLVER)
-		newS = new SimplifyingMinisat(bm->soft_timeout_expired);
-    else if (bm->UserFlags.solver_to_use == UserDefinedFlags::CRYPTOMINISAT_SOLVER)
-                    newS = new CryptoMinisat();
-    else if (bm->UserFlags.solver_to_use == UserDefinedFlags::MINISAT_SOLVER)
-      newS = new MinisatCore<Minisat::Solver>(bm->soft_timeout_expired);
-    else if (bm->UserFlags.solver_to_use == UserDefinedFlags::MINISAT_PROPAGATORS)
-      newS = new MinisatCore_prop<Minisat::Solver_prop>(bm->soft_timeout_expired);
-
-
+    const bool arrays = containsArrayOps(original_input);
 
-    SATSolver& NewSolver = *newS;
-
-
-    if(bm->UserFlags.stats_flag)
+    // Models with arrays in them aren't cached.
+    const bool caching = bm->UserFlags.isSet("query-cache", "1") && !arrays;
+    QueryCache::Key key;
+    if (caching)
       {
-	NewSolver.setVerbosity(1);
+        ASTNodeSet conjuncts;
+        flattenConjuncts(original_input, conjuncts);
+        key = queryCache.key(conjuncts);
+
+        SOLVER_RETURN_TYPE result = queryCache.lookup(key, original_input, Ctr_Example,
+            simp->getVariablesInExpression());
+        if (SOLVER_UNDECIDED != result)
+          return result;
       }
-    
-    if(bm->UserFlags.random_seed_flag)
+
+    // The last model often satisfies the next input of a stream of queries.
+    const bool reusing = bm->UserFlags.isSet("reuse-model", "1") && bm->UserFlags.construct_counterexample_flag
+        && !arrays;
+    if (reusing && tryLastModel(original_input))
       {
-        NewSolver.setSeed(bm->UserFlags.random_seed);
+        if (caching)
+          queryCache.store(key, original_input, SOLVER_INVALID, Ctr_Example, simp->getVariablesInExpression());
+        return SOLVER_INVALID;
       }
 
-	SOLVER_RETURN_TYPE result;
-    result = TopLevelSTPAux(NewSolver,
-			      original_input);
+    SOLVER_RETURN_TYPE result;
 
-    delete newS;
+    // Array problems go through the normal path, which does the refinement.
+    vector<ASTNodeSet> levels;
+    if (bm->UserFlags.incremental_flag && assertsAreLevels(inputasserts, levels) && !arrays)
+      result = TopLevelSTPIncremental(levels, query, original_input);
+
+    // The counterexample of a sliced input is put together from its parts.
+    else if (bm->UserFlags.isSet("slicing", "1") && bm->UserFlags.construct_counterexample_flag && !arrays)
+      result = TopLevelSTPSliced(original_input);
+
+    else
+      result = solveWithNewSolver(original_input);
+
+    if (caching)
+      queryCache.store(key, original_input, result, Ctr_Example, simp->getVariablesInExpression());
+
+    if (reusing && SOLVER_INVALID == result)
+      rememberModel(original_input);
 
-    bm->UserFlags.ackermannisation =saved_ack;
     return result;
 
   } //End of TopLevelSTP()
   
   ASTNode
-  STP::callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, const int initial_difficulty_score, int & actualBBSize)
+  STP::callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, simplifier::constantBitP::ConstantBitPropagationIncremental* cb, const int initial_difficulty_score, int & actualBBSize, SharedBitBlast* bitBlast)
   {
     while (true)
       {
         ASTNode last = simplified_solved_InputToSAT;
-        simplified_solved_InputToSAT = sizeReducing(last, bvSolver,pe);
+        simplified_solved_InputToSAT = sizeReducing(last, bvSolver,pe,cb);
         if (last == simplified_solved_InputToSAT)
           break;
       }
@@ -108,11 +491,12 @@ namespace BEEV {
     // Expensive, so only want to do it once.
     if (bm->UserFlags.isSet("bitblast-simplification", "1") && initial_difficulty_score < 250000)
       {
-        BBNodeManagerAIG bbnm;
-        BitBlaster<BBNodeAIG, BBNodeManagerAIG> bb(&bbnm, simp, bm->defaultNodeFactory , &(bm->UserFlags));
         ASTNodeMap fromTo;
         ASTNodeMap equivs;
-        bb.getConsts(simplified_solved_InputToSAT, fromTo,equivs);
+        bm->GetRunTimes()->start(RunTimes::BitBlasting);
+        const BBNodeAIG blasted = bitBlast->bb.getConsts(simplified_solved_InputToSAT, fromTo,equivs);
+        bm->GetRunTimes()->stop(RunTimes::BitBlasting);
+        actualBBSize = bitBlast->size(blasted);
 
         if (equivs.size() > 0)
           {
@@ -133,7 +517,6 @@ namespace BEEV {
             simplified_solved_InputToSAT = SubstitutionMap:: replace(simplified_solved_InputToSAT, fromTo, cache,bm->defaultNodeFactory);
             bm->ASTNodeStats(bb_message.c_str(), simplified_solved_InputToSAT);
           }
-        actualBBSize =  bbnm.totalNumberOfNodes();
       }
     return simplified_solved_InputToSAT;
   }
@@ -141,7 +524,7 @@ namespace BEEV {
 
   // These transformations should never increase the size of the DAG.
    ASTNode
-  STP::sizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe)
+  STP::sizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, simplifier::constantBitP::ConstantBitPropagationIncremental* cb)
   {
 
     simplified_solved_InputToSAT = pe->topLevel(simplified_solved_InputToSAT, arrayTransformer);
@@ -170,12 +553,11 @@ namespace BEEV {
     if (bm->UserFlags.bitConstantProp_flag)
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
-        simplifier::constantBitP::ConstantBitPropagation cb(simp, bm->defaultNodeFactory, simplified_solved_InputToSAT);
-        simplified_solved_InputToSAT = cb.topLevelBothWays(simplified_solved_InputToSAT, true,false);
+        simplified_solved_InputToSAT = cb->topLevelBothWays(simplified_solved_InputToSAT, false);
 
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
-        if (cb.isUnsatisfiable())
+        if (cb->isUnsatisfiable())
           simplified_solved_InputToSAT = bm->ASTFalse;
 
         if (simp->hasUnappliedSubstitutions())
@@ -230,7 +612,11 @@ namespace BEEV {
 
     // A heap object so I can easily control its lifetime.
     std::auto_ptr<BVSolver> bvSolver(new BVSolver(bm, simp));
+    std::auto_ptr<SharedBitBlast> bitBlast(new SharedBitBlast(bm));
     std::auto_ptr<PropagateEqualities> pe (new PropagateEqualities(simp,bm->defaultNodeFactory,bm));
+    std::auto_ptr<simplifier::constantBitP::ConstantBitPropagationIncremental> cbIncremental(
+        new simplifier::constantBitP::ConstantBitPropagationIncremental(simp, bm->defaultNodeFactory,
+            bm->UserFlags.isSet("incremental-cbitp", "1")));
 
     ASTNode simplified_solved_InputToSAT = original_input;
 
@@ -257,17 +643,17 @@ namespace BEEV {
       assert(!arrayops);
 
     // Run size reducing just once.
-    simplified_solved_InputToSAT = sizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get());
+    simplified_solved_InputToSAT = sizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get(),cbIncremental.get());
 
     unsigned initial_difficulty_score = difficulty.score(simplified_solved_InputToSAT);
 
     int bitblasted_difficulty = -1;
 
     // Fixed point it if it's not too difficult.
-    // Currently we discards all the state each time sizeReducing is called,
-    // so it's expensive to call.
+    // Apart from constant bit propagation, we discard all the state each time
+    // sizeReducing is called, so it's expensive to call.
     if ((!arrayops && initial_difficulty_score < 1000000) || bm->UserFlags.isSet("preserving-fixedpoint", "0"))
-           simplified_solved_InputToSAT = callSizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get(), initial_difficulty_score, bitblasted_difficulty);
+           simplified_solved_InputToSAT = callSizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get(), cbIncremental.get(), initial_difficulty_score, bitblasted_difficulty, bitBlast.get());
 
     if ((!arrayops || bm->UserFlags.isSet("array-difficulty-reversion", "1")))
       {
@@ -343,12 +729,11 @@ namespace BEEV {
     if (bm->UserFlags.bitConstantProp_flag)
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
-        simplifier::constantBitP::ConstantBitPropagation cb(simp, bm->defaultNodeFactory, simplified_solved_InputToSAT);
-        simplified_solved_InputToSAT = cb.topLevelBothWays(simplified_solved_InputToSAT);
+        simplified_solved_InputToSAT = cbIncremental->topLevelBothWays(simplified_solved_InputToSAT);
 
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
-        if (cb.isUnsatisfiable())
+        if (cbIncremental->isUnsatisfiable())
           simplified_solved_InputToSAT = bm->ASTFalse;
 
         bm->ASTNodeStats(cb_message.c_str(), simplified_solved_InputToSAT);
@@ -463,17 +848,17 @@ namespace BEEV {
     if (final_difficulty_score > 1.1 * initial_difficulty_score)
         worse = true;
 
-    // It's of course very wasteful to do this! Later I'll make it reuse the work..
-    // We bit-blast again, in order to throw it away, so that we can measure whether
-    // the number of AIG nodes is smaller. The difficulty score is sometimes completely
+    // We bit-blast again so that we can measure whether the number of AIG nodes is
+    // smaller. Only what has changed since the bit-blasting simplification is blasted,
+    // and the CNF generation reuses it. The difficulty score is sometimes completely
     // wrong, the sage-app7 are the motivating examples. The other way to improve it would
     // be to fix the difficulty scorer!
     if (!worse && (bitblasted_difficulty != -1))
      {
-        BBNodeManagerAIG bbnm;
-        BitBlaster<BBNodeAIG, BBNodeManagerAIG> bb(&bbnm, simp, bm->defaultNodeFactory , &(bm->UserFlags));
-        bb.BBForm(simplified_solved_InputToSAT);
-        int newBB=  bbnm.totalNumberOfNodes();
+        bm->GetRunTimes()->start(RunTimes::BitBlasting);
+        const BBNodeAIG blasted = bitBlast->bb.BBForm(simplified_solved_InputToSAT);
+        bm->GetRunTimes()->stop(RunTimes::BitBlasting);
+        int newBB = bitBlast->size(blasted);
         if (bm->UserFlags.stats_flag)
           cerr << "Final BB Size:" << newBB << endl;
 
@@ -540,12 +925,24 @@ namespace BEEV {
     // Deleting it clears out all the buckets associated with hashmaps etc. too.
     bvSolver.reset(NULL);
     pe.reset(NULL);
+    cbIncremental->clearTopDown();
 
 
     if (bm->UserFlags.stats_flag)
       simp->printCacheStatus();
 
-    const bool maybeRefinement = arrayops && !bm->UserFlags.ackermannisation;
+    // With lazy-mult-div, multiplications and divisions are only bit-blasted
+    // once a model gets them wrong. Their definitions are added as formulas,
+    // so the AIG converter has to keep its AIG. The bit-blaster's constant
+    // bits are those of the abstracted formula.
+    ASTNode toSAT = simplified_solved_InputToSAT;
+    bool multDivAbstracted = false;
+    if (bm->UserFlags.isSet("lazy-mult-div", "0") && !bm->UserFlags.isSet("traditional-cnf", "0")
+        && bm->UserFlags.isSet("incremental-cnf", "1"))
+      {
+        toSAT = Ctr_Example->AbstractMultDiv(simplified_solved_InputToSAT);
+        multDivAbstracted = Ctr_Example->hasMultDivAbstraction();
+      }
 
     simplifier::constantBitP::ConstantBitPropagation* cb = NULL;
     std::auto_ptr<simplifier::constantBitP::ConstantBitPropagation> cleaner;
@@ -553,28 +950,43 @@ namespace BEEV {
     if (bm->UserFlags.bitConstantProp_flag)
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
-        cb = new simplifier::constantBitP::ConstantBitPropagation(simp, bm->defaultNodeFactory,
-            simplified_solved_InputToSAT);
+        cb = cbIncremental->releaseBottomUp(toSAT);
         cleaner.reset(cb);
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
-        bm->ASTNodeStats(cb_message.c_str(), simplified_solved_InputToSAT);
+        bm->ASTNodeStats(cb_message.c_str(), toSAT);
 
         if (cb->isUnsatisfiable())
-          simplified_solved_InputToSAT = bm->ASTFalse;
+          simplified_solved_InputToSAT = toSAT = bm->ASTFalse;
       }
 
-    ToSATAIG toSATAIG(bm, cb, arrayTransformer);
+    // Cheap when there are lots of models.
+    res = Ctr_Example->RandomSimulation(simplified_solved_InputToSAT, original_input, cb);
+    if (SOLVER_INVALID == res)
+      {
+        CountersAndStats("print_func_stats", bm);
+        return res;
+      }
+
+    ToSATAIG toSATAIG(bm, cb, arrayTransformer, bitBlast.get());
 
     ToSATBase* satBase = bm->UserFlags.isSet("traditional-cnf", "0") ? tosat : ((ToSAT*) &toSATAIG) ;
 
     if (bm->soft_timeout_expired)
         return SOLVER_TIMEOUT;
 
+    const bool maybeRefinement = (arrayops && !bm->UserFlags.ackermannisation) || multDivAbstracted;
+
     // If it doesn't contain array operations, use ABC's CNF generation.
-    res = Ctr_Example->CallSAT_ResultCheck(NewSolver, simplified_solved_InputToSAT, original_input, satBase,
+    res = Ctr_Example->CallSAT_ResultCheck(NewSolver, toSAT, original_input, satBase,
         maybeRefinement);
 
+    // The abstracted operations that the model gets wrong are defined first.
+    // If it's still wrong, the array axioms go in, then the operations
+    // that the new model gets wrong.
+    if (SOLVER_UNDECIDED == res && multDivAbstracted && !bm->soft_timeout_expired)
+      res = Ctr_Example->SATBased_MultDivRefinement(NewSolver, original_input, satBase);
+
     if (bm->soft_timeout_expired)
       {
         if (toSATAIG.cbIsDestructed())
@@ -593,11 +1005,17 @@ namespace BEEV {
         return res;
       }
 
-    assert(arrayops); // should only go to abstraction refinement if there are array ops.
-    assert(!bm->UserFlags.ackermannisation); // Refinement must be enabled too.
-    assert (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS); // The array solver shouldn't have returned undecided..
+    if (arrayops && bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS)
+      {
+        assert(!bm->UserFlags.ackermannisation); // Refinement must be enabled too.
+        res = Ctr_Example->SATBased_ArrayReadRefinement(NewSolver, toSAT, original_input, satBase);
+      }
+    else
+      assert(multDivAbstracted); // should only go to abstraction refinement if there are array ops.
+
+    if (SOLVER_UNDECIDED == res && multDivAbstracted && !bm->soft_timeout_expired)
+      res = Ctr_Example->SATBased_MultDivRefinement(NewSolver, original_input, satBase);
 
-    res = Ctr_Example->SATBased_ArrayReadRefinement(NewSolver, simplified_solved_InputToSAT, original_input, satBase);
     if (SOLVER_UNDECIDED != res)
       {
         if (toSATAIG.cbIsDestructed())
@@ -19,16 +19,28 @@
 #include "../parser/LetMgr.h"
 #include "../absrefine_counterexample/AbsRefine_CounterExample.h"
 #include "../simplifier/PropagateEqualities.h"
+#include "QueryCache.h"
 #include "../boost/noncopyable.hpp"
 
+namespace simplifier
+{
+  namespace constantBitP
+  {
+    class ConstantBitPropagationIncremental;
+  }
+}
+
 namespace BEEV
 {
+  class ToSATAIGIncremental;
+  class SharedBitBlast;
+
   class STP  : boost::noncopyable
   {
 
     
 
-          ASTNode sizeReducing(ASTNode input, BVSolver* bvSolver, PropagateEqualities *pe);
+          ASTNode sizeReducing(ASTNode input, BVSolver* bvSolver, PropagateEqualities *pe, simplifier::constantBitP::ConstantBitPropagationIncremental* cb);
 
           // A copy of all the state we need to restore to a prior expression.
           struct Revert_to
@@ -46,12 +58,55 @@ namespace BEEV
                                             const ASTNode& modified_input
                                             );
 
+          // Creates the SAT solver selected by the user flags.
+          SATSolver* createSolver();
+
+          // When the user asks for it, the SAT solver is kept between queries.
+          // Each assertion level is guarded by an activation literal that is
+          // assumed while the level is on the stack.
+          struct ActivationLevel
+          {
+            SATSolver::Var activation;
+            ASTNodeSet encoded; // The conjuncts already sent to the solver.
+          };
+          SATSolver* incrementalSolver;
+          ToSATAIGIncremental* incrementalToSAT;
+          vector<ActivationLevel> activationLevels;
+
+          // Splits the assertion levels into their conjuncts. Returns false if
+          // they aren't what's being asked about.
+          bool assertsAreLevels(const ASTNode& inputasserts, vector<ASTNodeSet>& levels);
+
+          SOLVER_RETURN_TYPE TopLevelSTPIncremental(const vector<ASTNodeSet>& levels,
+                                                    const ASTNode& query,
+                                                    const ASTNode& original_input);
+
+          // Splits the input into parts that share no variables. The parts
+          // that an earlier query showed are satisfiable aren't solved again.
+          SOLVER_RETURN_TYPE TopLevelSTPSliced(const ASTNode& original_input);
+
+          // Solves "input" with a fresh SAT solver.
+          SOLVER_RETURN_TYPE solveWithNewSolver(const ASTNode& input);
+
+          // Satisfiable parts of earlier inputs, with the values of their variables.
+          typedef HASHMAP<ASTNode, ASTNodeMap, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual> PartToModel;
+          PartToModel satisfiableParts;
+
+          // Answers to earlier inputs.
+          QueryCache queryCache;
+
+          // The latest value of each symbol in the models of earlier inputs.
+          // It's tried on each input before the input is solved.
+          ASTNodeMap lastModel;
+          bool tryLastModel(const ASTNode& input);
+          void rememberModel(const ASTNode& input);
+
 
   public:
 ArrayTransformer * arrayTransformer;
     
           // calls sizeReducing and the bitblasting simplification.
-          ASTNode callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, const int initial_difficulty_score, int & actualBBSize);
+          ASTNode callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, simplifier::constantBitP::ConstantBitPropagationIncremental* cb, const int initial_difficulty_score, int & actualBBSize, SharedBitBlast* bitBlast);
 
 
     /****************************************************************
@@ -73,13 +128,16 @@ ArrayTransformer * arrayTransformer;
         Simplifier* s,
         ArrayTransformer * a,
         ToSATBase * ts,
-        AbsRefine_CounterExample * ce)
+        AbsRefine_CounterExample * ce) :
+      queryCache(b)
     {
       bm   = b;
       simp = s;
       tosat = ts;
       arrayTransformer = a;
       Ctr_Example = ce;
+      incrementalSolver = NULL;
+      incrementalToSAT = NULL;
     }// End of constructor
 
 
@@ -89,7 +147,8 @@ ArrayTransformer * arrayTransformer;
         BVSolver* bsolv,
         ArrayTransformer * a,
         ToSATBase * ts,
-        AbsRefine_CounterExample * ce)    
+        AbsRefine_CounterExample * ce) :
+      queryCache(b)
     {
       bm   = b;
       simp = s;
@@ -97,21 +156,11 @@ ArrayTransformer * arrayTransformer;
       delete bsolv; // Remove from the constructor later..
       arrayTransformer = a;
       Ctr_Example = ce;
+      incrementalSolver = NULL;
+      incrementalToSAT = NULL;
     }// End of constructor
 
-    ~STP()
-    {
-      ClearAllTables();
-      delete Ctr_Example;
-      Ctr_Example = NULL;
-      delete arrayTransformer;
-      arrayTransformer = NULL;
-      delete tosat;
-      tosat = NULL;
-      delete simp;
-      simp = NULL;
-      //delete bm;
-    }
+    ~STP();
 
     /****************************************************************
      * Public Member Functions                                      *
@@ -19,67 +19,38 @@
 
 namespace BEEV
 {
-  ASTInterior *STPMgr::LookupOrCreateInterior(ASTInterior *n_ptr)
+  ASTInterior *STPMgr::LookupOrCreateInterior(Kind kind, ASTVec & children)
   {
-    ASTInteriorSet::iterator it = _interior_unique_table.find(n_ptr);
-    if (it == _interior_unique_table.end())
-      {
-        // Make a new ASTInterior node We want (NOT alpha) always to
-        // have alpha.nodenum + 1.
-        if (n_ptr->GetKind() == NOT)
-          {
-        	// The internal node can't be a NOT, because then we'd add
-        	// 1 to the NOT's node number, meaning we'd hit an even number,
-        	// which could duplicate the next newNodeNum().
-        	assert(n_ptr->GetChildren()[0].GetKind() != NOT);
-       		n_ptr->SetNodeNum(n_ptr->GetChildren()[0].GetNodeNum() + 1);
-          }
-        else
-          {
-            n_ptr->SetNodeNum(NewNodeNum());
-          }
-        pair<ASTInteriorSet::const_iterator, bool> p = 
-          _interior_unique_table.insert(n_ptr);
-        return *(p.first);
-      }
-    else
-      // Delete the temporary node, and return the found node.
-      delete n_ptr;
-    return *it;
-  }
+    // The children are swapped into a temporary key, rather than
+    // copied, and swapped back after the lookup.
+    ASTInterior key(kind);
+    key._children.swap(children);
+    ASTInteriorSet::const_iterator it = _interior_unique_table.find(&key);
+    key._children.swap(children);
 
-  
- 
+    if (it != _interior_unique_table.end())
+      return *it;
 
-  ASTInterior *STPMgr::CreateInteriorNode(Kind kind,
-                                          // children array of this
-                                          // node will be modified.
-                                          ASTInterior *n_ptr,
-                                          const ASTVec & back_children)
-  {
-
-    // insert back_children at end of front_children
-    ASTVec &front_children = n_ptr->_children;
-	front_children.reserve(front_children.size()+ back_children.size());
-
-    front_children.insert(front_children.end(), 
-                          back_children.begin(), 
-                          back_children.end());
+    // Make a new ASTInterior node.
+    ASTInterior *n_ptr = new (_interior_slab.allocate()) ASTInterior(kind, children);
 
-    // check for undefined nodes.
-    ASTVec::const_iterator it_end = front_children.end();
-    for (ASTVec::const_iterator it = front_children.begin();
-	 it != it_end; it++)
+    // We want (NOT alpha) always to have alpha.nodenum + 1.
+    if (kind == NOT)
       {
-        if (it->IsNull())
-          {
-            FatalError("CreateInteriorNode:"\
-                       "Undefined childnode in CreateInteriorNode: ", 
-                       ASTUndefined);
-          }
+        // The internal node can't be a NOT, because then we'd add
+        // 1 to the NOT's node number, meaning we'd hit an even number,
+        // which could duplicate the next newNodeNum().
+        assert(children[0].GetKind() != NOT);
+        n_ptr->SetNodeNum(children[0].GetNodeNum() + 1);
       }
-
-    return LookupOrCreateInterior(n_ptr);
+    else
+      {
+        n_ptr->SetNodeNum(NewNodeNum());
+      }
+    n_ptr->_bm = this;
+    pair<ASTInteriorSet::const_iterator, bool> p =
+      _interior_unique_table.insert(n_ptr);
+    return *(p.first);
   }
 
   ostream &operator<<(ostream &os, const ASTNodeMap &nmap)
@@ -128,9 +99,10 @@ namespace BEEV
         // _name because it's const).  Can cast the iterator to
         // non-const -- carefully.
         //std::string strname(s_ptr->GetName());
-        ASTSymbol * s_ptr1 = new ASTSymbol(strdup(s_ptr->GetName()));
+        ASTSymbol * s_ptr1 = new (_symbol_slab.allocate()) ASTSymbol(strdup(s_ptr->GetName()));
         s_ptr1->SetNodeNum(NewNodeNum());
         s_ptr1->_value_width = s_ptr->_value_width;
+        s_ptr1->_bm = this;
         pair<ASTSymbolSet::const_iterator, bool> p = 
           _symbol_unique_table.insert(s_ptr1);
         return *p.first;
@@ -383,8 +355,9 @@ namespace BEEV
       {
         // Make a new ASTBVConst with duplicated constant.
 
-        ASTBVConst * s_copy = new ASTBVConst(s);
+        ASTBVConst * s_copy = new (_bvconst_slab.allocate()) ASTBVConst(s);
         s_copy->SetNodeNum(NewNodeNum());
+        s_copy->_bm = this;
 
         pair<ASTBVConstSet::const_iterator, bool> p = 
 	  _bvconst_unique_table.insert(s_copy);
@@ -13,6 +13,7 @@
 #include "UserDefinedFlags.h"
 #include "../AST/AST.h"
 #include "../AST/NodeFactory/HashingNodeFactory.h"
+#include "../AST/NodeSlab.h"
 #include "../sat/SATSolver.h"
 #include "../boost/noncopyable.hpp"
 
@@ -62,6 +63,12 @@ namespace BEEV
       ASTNode::ASTNodeEqual> ASTNodeToSetMap;
 #endif
 
+    // The nodes in the unique tables are allocated from these. They are
+    // declared first so that they outlive everything else.
+    NodeSlab<ASTInterior> _interior_slab;
+    NodeSlab<ASTSymbol> _symbol_slab;
+    NodeSlab<ASTBVConst> _bvconst_slab;
+
     // Unique node tables that enables common subexpression sharing
     ASTInteriorSet _interior_unique_table;
 
@@ -85,6 +92,9 @@ namespace BEEV
 
     volatile bool soft_timeout_expired;
 
+    // Used by CountersAndStats().
+    function_counters functionCounters;
+
     // No nodes should already have the iteration number that is returned from here.
     // This never returns zero.
     uint8_t getNextIteration()
@@ -118,6 +128,12 @@ namespace BEEV
       return _asserts.size();
     }
 
+    // The assertions made at a level of the logical context.
+    const ASTVec& getAssertsAtLevel(int level)
+    {
+      return *_asserts[level];
+    }
+
   private:
 
     // Stack of Logical Context. each entry in the stack is a logical
@@ -141,17 +157,10 @@ namespace BEEV
      * Private Member Functions                                     *
      ****************************************************************/
     
-    // Destructively appends back_child nodes to front_child nodes.
-    // If back_child nodes is NULL, no appending is done.  back_child
-    // nodes are not modified.  Then it returns the hashed copy of the
-    // node, which is created if necessary.
-    ASTInterior *CreateInteriorNode(Kind kind, 
-                                    ASTInterior *new_node,
-                                    const ASTVec & back_children = 
-                                    _empty_ASTVec);
-
-    // Create unique ASTInterior node.
-    ASTInterior *LookupOrCreateInterior(ASTInterior *n);
+    // Create unique ASTInterior node. The table is probed before
+    // anything is allocated, so finding an existing node is cheap.
+    // The children are only borrowed, and are unchanged on return.
+    ASTInterior *LookupOrCreateInterior(Kind kind, ASTVec & children);
 
     // Create unique ASTSymbol node.
     ASTSymbol *LookupOrCreateSymbol(ASTSymbol& s);
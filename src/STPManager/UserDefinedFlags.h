@@ -129,6 +129,13 @@ namespace BEEV
 
     bool simplify_during_BB_flag;
 
+    // Keep one SAT solver between queries, guarding each assertion level
+    // with an activation literal.
+    bool incremental_flag;
+
+    // If more than one, this many SAT solvers race on each problem.
+    int portfolio_size;
+
     // Available back-end SAT solvers.
     enum SATSolvers
       {
@@ -294,6 +301,10 @@ namespace BEEV
       // If the bit-blaster discovers new constants, should the term simplifier be re-run.
       simplify_during_BB_flag=false;
 
+      incremental_flag = false;
+
+      portfolio_size = 1;
+
     } //End of constructor for UserDefinedFlags
 
   }; //End of struct UserDefinedFlags
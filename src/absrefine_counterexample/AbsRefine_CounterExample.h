@@ -17,6 +17,14 @@
 #include "../to-sat/ToSATBase.h"
 #include "../boost/noncopyable.hpp"
 
+namespace simplifier
+{
+  namespace constantBitP
+  {
+    class ConstantBitPropagation;
+  }
+}
+
 namespace BEEV
 {
   class AbsRefine_CounterExample : boost::noncopyable
@@ -47,6 +55,19 @@ namespace BEEV
     // false. Otherwise we know that the counter_example is bogus.
     void CheckCounterExample(bool t);
 
+    // Fills ComputeFormulaMap for "formulas" using a ModelEvaluator,
+    // which doesn't create nodes. Those it can't evaluate are left for
+    // ComputeFormulaUsingModel.
+    void ComputeFormulasCompiled(const ASTVec& formulas);
+
+    // Evaluates "original_input" against the counterexample, which must
+    // give it a value.
+    ASTNode EvaluateInput(const ASTNode& original_input);
+
+    // Checks and prints the counterexample, if the flags ask for it, as is
+    // done for one from the SAT solver.
+    void CheckAndPrintCounterExample();
+
     // Accepts a term and turns it into a constant-term w.r.t
     // counter_example
     ASTNode TermToConstTermUsingModel(const ASTNode& term, 
@@ -67,6 +88,12 @@ namespace BEEV
     // Prints MINISAT assigment one bit at a time, for debugging.
     void PrintSATModel(SATSolver& S, ToSATBase::ASTNodeToSATVar& satVarToSymbol);
 
+    // The fresh variables that multiplications and divisions were replaced
+    // by, each with the term it stands for. The term's operands may be
+    // fresh variables too. Those already defined in the solver are dropped.
+    vector<pair<ASTNode, ASTNode> > multDivAbstracted;
+    ASTNode AbstractMultDiv(const ASTNode& n, ASTNodeMap& cache, ASTVec& constraints);
+
 
   public:
 
@@ -104,6 +131,19 @@ namespace BEEV
     //queries the counterexample, and returns a vector of index-value pairs for e
     std::vector<std::pair<ASTNode, ASTNode> > GetCounterExampleArray(bool t, const ASTNode& e);
 
+    // Puts the values of "symbols" in the counterexample into "values".
+    void GetCounterExampleValues(const ASTVec& symbols, ASTNodeMap& values);
+
+    // Replaces the counterexample with "model", which was put together from
+    // solving parts of the input separately. Then checks and prints it as
+    // if it had come from the SAT solver.
+    void SetCounterExample(const ASTNodeMap& model);
+
+    // Makes "model" the counterexample if it satisfies "original_input".
+    // Symbols that it doesn't give a value to are zero. It's then checked
+    // and printed as if it had come from the SAT solver.
+    bool TrySetCounterExample(const ASTNodeMap& model, const ASTNode& original_input);
+
     int CounterExampleSize(void) const
     {
       return CounterExampleMap.size();
@@ -131,6 +171,16 @@ namespace BEEV
                         ToSATBase* tosat,
                         bool refinement);
 
+    // Before bit-blasting, tries assignments to the symbols of
+    // "modified_input" that are mostly random. Some follow the bits that
+    // "cb", which can be NULL, has fixed. Returns SOLVER_INVALID with the
+    // counterexample set if one satisfies "original_input", otherwise
+    // SOLVER_UNDECIDED.
+    SOLVER_RETURN_TYPE
+    RandomSimulation(const ASTNode& modified_input,
+                     const ASTNode& original_input,
+                     simplifier::constantBitP::ConstantBitPropagation* cb);
+
     
     SOLVER_RETURN_TYPE 
     SATBased_ArrayReadRefinement(SATSolver& newS,
@@ -141,6 +191,25 @@ namespace BEEV
     void
     applyAllCongruenceConstraints(SATSolver & SatSolver, ToSATBase *tosat);
 
+    // Replaces the multiplications and divisions in "input" that have no
+    // constant operand by fresh variables, and conjoins cheap constraints
+    // on them, e.g. that a product's low bit is the AND of its operands'.
+    // The result is implied by "input", so UNSAT is final, but a model may
+    // get those operations wrong.
+    ASTNode AbstractMultDiv(const ASTNode& input);
+    bool
+    hasMultDivAbstraction() const
+    {
+      return !multDivAbstracted.empty();
+    }
+    // Defines the abstracted terms that the model gets wrong, and solves
+    // again, until a model is right or the model doesn't get any wrong.
+    // Returns SOLVER_UNDECIDED in the latter case.
+    SOLVER_RETURN_TYPE
+    SATBased_MultDivRefinement(SATSolver& SatSolver,
+                               const ASTNode& original_input,
+                               ToSATBase* tosat);
+
 
 #if 0
     SOLVER_RETURN_TYPE 
@@ -161,6 +230,7 @@ namespace BEEV
     {
       CounterExampleMap.clear();
       ComputeFormulaMap.clear();
+      multDivAbstracted.clear();
     } //End of ClearAllTables()
 
     ~AbsRefine_CounterExample()
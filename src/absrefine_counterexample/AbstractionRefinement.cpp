@@ -30,7 +30,17 @@ namespace BEEV
     {
         ToSATBase::ASTNodeToSATVar::iterator it = satVar.find(a);
         if (it != satVar.end())
-            v_a = it->second;
+            {
+                // Bits that weren't encoded get fresh variables too.
+                vector<unsigned>& v = it->second;
+                for (int i = 0; i < v.size(); i++)
+                    if (v[i] == ~((unsigned) 0))
+                        {
+                            v[i] = SatSolver.newVar();
+                            SatSolver.setFrozen(v[i]);
+                        }
+                v_a = v;
+            }
         else if (!a.isConstant())
             {
                 assert(a.GetKind() == SYMBOL);
@@ -221,6 +231,26 @@ namespace BEEV
         toBe.clear();
     }
 
+    // Adds the axioms, and returns what else CallSAT needs to be given. If
+    // the converter can add formulas, they're bit-blasted like the rest of
+    // the problem, so they share its AIG nodes and get its CNF mapping.
+    ASTNode
+    applyAxioms(STPMgr* bm, ToSATBase* tosat, vector<AxiomToBe> & toBe, SATSolver & SatSolver)
+    {
+        if (!tosat->canAddFormulas() || !bm->UserFlags.isSet("aig-axioms", "1"))
+            {
+                applyAxiomsToSolver(tosat->SATVar_to_SymbolIndexMap(), toBe, SatSolver);
+                return bm->CreateNode(TRUE);
+            }
+
+        ASTVec axioms;
+        for (int i = 0; i < toBe.size(); i++)
+            axioms.push_back(bm->CreateNode(IMPLIES, bm->CreateNode(EQ, toBe[i].index0, toBe[i].index1),
+                    bm->CreateNode(EQ, toBe[i].value0, toBe[i].value1)));
+        toBe.clear();
+        return (axioms.size() == 1) ? axioms[0] : bm->CreateNode(AND, axioms);
+    }
+
     bool
     sortBySize(const pair<ASTNode, ArrayTransformer::arrTypeMap>& a,
             const pair<ASTNode, ArrayTransformer::arrTypeMap>& b)
@@ -270,7 +300,7 @@ namespace BEEV
                 iset_end = arrayToIndex.end(); iset != iset_end; iset++)
             {
                 const ASTNode& ArrName = iset->first;
-                const map<ASTNode, ArrayTransformer::ArrayRead>& mapper = iset->second;
+                const ArrayTransformer::arrTypeMap& mapper = iset->second;
 
                 vector<ASTNode> listOfIndices;
                 listOfIndices.reserve(mapper.size());
@@ -350,12 +380,11 @@ namespace BEEV
                             }
                         if (FalseAxiomsVec.size() > 0)
                             {
-                                ToSATBase::ASTNodeToSATVar & satVar = tosat->SATVar_to_SymbolIndexMap();
-                                applyAxiomsToSolver(satVar, FalseAxiomsVec, SatSolver);
+                                const ASTNode axioms = applyAxioms(bm, tosat, FalseAxiomsVec, SatSolver);
 
                                 SOLVER_RETURN_TYPE res2;
                                 bm->GetRunTimes()->stop(RunTimes::ArrayReadRefinement);
-                                res2 = CallSAT_ResultCheck(SatSolver, ASTTrue, original_input, tosat, true);
+                                res2 = CallSAT_ResultCheck(SatSolver, axioms, original_input, tosat, true);
 
                                 if (SOLVER_UNDECIDED != res2)
                                     return res2;
@@ -370,6 +399,8 @@ namespace BEEV
                 {
                         cout << "Adding all the remaining " << RemainingAxiomsVec.size() << " read axioms " << endl;
                 }
+                // There can be thousands of these, so they get the smaller
+                // one-sided encoding, rather than going through the AIG.
                 ToSATBase::ASTNodeToSATVar & satVar = tosat->SATVar_to_SymbolIndexMap();
                 applyAxiomsToSolver(satVar, RemainingAxiomsVec, SatSolver);
 
@@ -418,6 +449,134 @@ namespace BEEV
     } //end of SATBased_ArrayReadRefinement
 
 
+  /******************************************************************
+   * MULTIPLICATION AND DIVISION ABSTRACTION REFINEMENT
+   *
+   * Multiplications and divisions are expensive to bit-blast, and often
+   * a model can be found without most of them. AbstractMultDiv()
+   * replaces each by a fresh variable, with some constraints that are
+   * cheap to bit-blast. After each solve, SATBased_MultDivRefinement()
+   * evaluates the replaced terms in the model, and adds "variable =
+   * term" for those the model gets wrong.
+   *****************************************************************/
+  ASTNode
+  AbsRefine_CounterExample::AbstractMultDiv(const ASTNode& n, ASTNodeMap& cache, ASTVec& constraints)
+  {
+    if (n.Degree() == 0 || n.GetType() == ARRAY_TYPE)
+      return n;
+
+    ASTNodeMap::const_iterator it = cache.find(n);
+    if (it != cache.end())
+      return it->second;
+
+    ASTVec children;
+    children.reserve(n.Degree());
+    bool changed = false;
+    for (int i = 0; i < n.Degree(); i++)
+      {
+        children.push_back(AbstractMultDiv(n[i], cache, constraints));
+        changed |= (children.back() != n[i]);
+      }
+
+    ASTNode result = n;
+    if (changed)
+      {
+        if (n.GetType() == BOOLEAN_TYPE)
+          result = bm->CreateNode(n.GetKind(), children);
+        else
+          result = bm->CreateTerm(n.GetKind(), n.GetValueWidth(), children);
+      }
+
+    const Kind k = n.GetKind();
+    const bool nonLinear = (k == BVMULT || k == BVDIV || k == BVMOD || k == SBVDIV || k == SBVREM || k == SBVMOD);
+    if (nonLinear && result.Degree() == 2 && !result[0].isConstant() && !result[1].isConstant())
+      {
+        const unsigned width = n.GetValueWidth();
+        const ASTNode& a = result[0];
+        const ASTNode& b = result[1];
+        const ASTNode v = bm->CreateFreshVariable(0, width, "STP__MultDiv");
+        multDivAbstracted.push_back(make_pair(v, result));
+
+        const ASTNode zero = bm->CreateZeroConst(width);
+        const ASTNode bIsZero = bm->CreateNode(EQ, b, zero);
+        if (k == BVMULT)
+          {
+            // The low bit, and the products by zero and one.
+            const ASTNode low = bm->CreateZeroConst(32);
+            constraints.push_back(bm->CreateNode(EQ, bm->CreateTerm(BVEXTRACT, 1, v, low, low),
+                bm->CreateTerm(BVAND, 1, bm->CreateTerm(BVEXTRACT, 1, a, low, low),
+                    bm->CreateTerm(BVEXTRACT, 1, b, low, low))));
+            constraints.push_back(bm->CreateNode(IMPLIES,
+                bm->CreateNode(OR, bm->CreateNode(EQ, a, zero), bIsZero), bm->CreateNode(EQ, v, zero)));
+            const ASTNode one = bm->CreateOneConst(width);
+            constraints.push_back(bm->CreateNode(IMPLIES, bm->CreateNode(EQ, a, one), bm->CreateNode(EQ, v, b)));
+            constraints.push_back(bm->CreateNode(IMPLIES, bm->CreateNode(EQ, b, one), bm->CreateNode(EQ, v, a)));
+          }
+        else if (k == BVDIV)
+          constraints.push_back(bm->CreateNode(IMPLIES, bm->CreateNode(NOT, bIsZero), bm->CreateNode(BVLE, v, a)));
+        else if (k == BVMOD)
+          constraints.push_back(bm->CreateNode(IMPLIES, bm->CreateNode(NOT, bIsZero),
+              bm->CreateNode(AND, bm->CreateNode(BVLT, v, b), bm->CreateNode(BVLE, v, a))));
+
+        result = v;
+      }
+
+    cache.insert(make_pair(n, result));
+    return result;
+  }
+
+  ASTNode
+  AbsRefine_CounterExample::AbstractMultDiv(const ASTNode& input)
+  {
+    multDivAbstracted.clear();
+
+    ASTNodeMap cache;
+    ASTVec constraints;
+    ASTNode result = AbstractMultDiv(input, cache, constraints);
+    if (constraints.empty())
+      return result;
+
+    constraints.push_back(result);
+    result = bm->CreateNode(AND, constraints);
+    if (bm->UserFlags.stats_flag)
+      cerr << "Abstracted " << multDivAbstracted.size() << " multiplications and divisions" << endl;
+    return result;
+  }
+
+  SOLVER_RETURN_TYPE
+  AbsRefine_CounterExample::SATBased_MultDivRefinement(SATSolver& SatSolver, const ASTNode& original_input,
+      ToSATBase* tosat)
+  {
+    while (true)
+      {
+        bm->GetRunTimes()->start(RunTimes::MultDivRefinement);
+        ASTVec definitions;
+        vector<pair<ASTNode, ASTNode> > remaining;
+        for (int i = 0; i < multDivAbstracted.size(); i++)
+          {
+            const ASTNode& v = multDivAbstracted[i].first;
+            const ASTNode& term = multDivAbstracted[i].second;
+            if (TermToConstTermUsingModel(v, false) != TermToConstTermUsingModel(term, false))
+              definitions.push_back(bm->CreateNode(EQ, v, term));
+            else
+              remaining.push_back(multDivAbstracted[i]);
+          }
+        multDivAbstracted.swap(remaining);
+        bm->GetRunTimes()->stop(RunTimes::MultDivRefinement);
+
+        if (definitions.empty())
+          return SOLVER_UNDECIDED;
+
+        if (bm->UserFlags.stats_flag)
+          cerr << "Adding " << definitions.size() << " multiplication and division definitions" << endl;
+
+        const ASTNode toAdd = (definitions.size() == 1) ? definitions[0] : bm->CreateNode(AND, definitions);
+        const SOLVER_RETURN_TYPE res = CallSAT_ResultCheck(SatSolver, toAdd, original_input, tosat, true);
+        if (SOLVER_UNDECIDED != res)
+          return res;
+      }
+  }
+
 #if 0
     // This isn't currently wired up.
 
@@ -520,7 +679,7 @@ namespace BEEV
         arrayToIndex.end(); iset != iset_end; iset++)
       {
       //const ASTNode& ArrName = iset->first;
-      const map<ASTNode, ArrayTransformer::ArrayRead>& mapper = iset->second;
+      const ArrayTransformer::arrTypeMap& mapper = iset->second;
 
       vector<ASTNode> listOfIndices;
       listOfIndices.reserve(mapper.size());
@@ -535,7 +694,7 @@ namespace BEEV
       ASTVec index_symbols;
       index_symbols.reserve(mapper.size());
 
-      for (map<ASTNode, ArrayTransformer::ArrayRead>::const_iterator it = mapper.begin();
+      for (ArrayTransformer::arrTypeMap::const_iterator it = mapper.begin();
           it != mapper.end(); it++)
         {
         const ASTNode& the_index = it->first;
@@ -8,6 +8,7 @@
  ********************************************************************/
 
 #include "AbsRefine_CounterExample.h"
+#include "ModelEvaluator.h"
 #include "../printer/printers.h"
 #include "../to-sat/AIG/ToSATAIG.h"
 
@@ -86,9 +87,9 @@ namespace BEEV
         ArrayTransform->arrayToIndexToRead.end(); it != itend; it++)
       {
         const ASTNode& array = it->first;
-        const map<ASTNode, ArrayTransformer::ArrayRead>& mapper = it->second;
+        const ArrayTransformer::arrTypeMap& mapper = it->second;
 
-        for (map<ASTNode, ArrayTransformer::ArrayRead>::const_iterator it2 = mapper.begin(), it2end = mapper.end(); it2
+        for (ArrayTransformer::arrTypeMap::const_iterator it2 = mapper.begin(), it2end = mapper.end(); it2
             != it2end; it2++)
           {
             const ASTNode& index = it2->first;
@@ -554,6 +555,27 @@ namespace BEEV
     return output;
   }
 
+  void
+  AbsRefine_CounterExample::ComputeFormulasCompiled(const ASTVec& formulas)
+  {
+    if (!bm->UserFlags.isSet("compiled-evaluator", "1"))
+      return;
+
+    ASTVec roots;
+    for (ASTVec::const_iterator it = formulas.begin(); it != formulas.end(); it++)
+      if (ComputeFormulaMap.find(*it) == ComputeFormulaMap.end())
+        roots.push_back(*it);
+    if (roots.empty())
+      return;
+
+    ModelEvaluator evaluator(bm);
+    if (!evaluator.compile(roots, CounterExampleMap) || !evaluator.run())
+      return;
+
+    for (ASTVec::const_iterator it = roots.begin(); it != roots.end(); it++)
+      ComputeFormulaMap[*it] = evaluator.isTrue(*it) ? ASTTrue : ASTFalse;
+  }
+
   void
   AbsRefine_CounterExample::CheckCounterExample(bool t)
   {
@@ -567,6 +589,11 @@ namespace BEEV
                  "No CounterExample to check", ASTUndefined);
     const ASTVec c = bm->GetAsserts();
 
+    ASTVec toCheck(c);
+    if (bm->GetQuery() != ASTUndefined)
+      toCheck.push_back(bm->GetQuery());
+    ComputeFormulasCompiled(toCheck);
+
     if (bm->UserFlags.stats_flag)
         printf("checking counterexample\n");
 
@@ -589,6 +616,69 @@ namespace BEEV
                  "NOT OK", bm->GetQuery());
   }
 
+  void
+  AbsRefine_CounterExample::GetCounterExampleValues(const ASTVec& symbols, ASTNodeMap& values)
+  {
+    for (ASTVec::const_iterator it = symbols.begin(); it != symbols.end(); it++)
+      {
+        const ASTNode& s = *it;
+        // Evaluating a symbol that was simplified out would add it to the
+        // counterexample.
+        if (CounterExampleMap.find(s) == CounterExampleMap.end())
+          values[s] = (BOOLEAN_TYPE == s.GetType()) ? ASTFalse : bm->CreateZeroConst(s.GetValueWidth());
+        else if (BOOLEAN_TYPE == s.GetType())
+          values[s] = ComputeFormulaUsingModel(s);
+        else
+          values[s] = TermToConstTermUsingModel(s, false);
+      }
+  }
+
+  void
+  AbsRefine_CounterExample::SetCounterExample(const ASTNodeMap& model)
+  {
+    CounterExampleMap = model;
+    ComputeFormulaMap.clear();
+    CheckAndPrintCounterExample();
+  }
+
+  bool
+  AbsRefine_CounterExample::TrySetCounterExample(const ASTNodeMap& model, const ASTNode& original_input)
+  {
+    CounterExampleMap = model;
+    ComputeFormulaMap.clear();
+
+    // A model that divides by zero, when that's an error, isn't taken.
+    const bool checking = bm->counterexample_checking_during_refinement;
+    bm->counterexample_checking_during_refinement = true;
+    bm->bvdiv_exception_occured = false;
+    const bool satisfies = (ASTTrue == EvaluateInput(original_input));
+    bm->counterexample_checking_during_refinement = checking;
+    bm->bvdiv_exception_occured = false;
+
+    if (!satisfies)
+      {
+        CounterExampleMap.clear();
+        ComputeFormulaMap.clear();
+        return false;
+      }
+
+    CheckAndPrintCounterExample();
+    return true;
+  }
+
+  void
+  AbsRefine_CounterExample::CheckAndPrintCounterExample()
+  {
+    if (bm->UserFlags.check_counterexample_flag)
+      CheckCounterExample(true);
+
+    if (bm->UserFlags.stats_flag || bm->UserFlags.print_counterexample_flag)
+      {
+        PrintCounterExample(true);
+        PrintCounterExample_InOrder(true);
+      }
+  }
+
   /* FUNCTION: queries the CounterExampleMap object with 'expr' and
    * returns the corresponding counterexample value.
    */
@@ -912,6 +1002,28 @@ namespace BEEV
       }
   }
 
+  ASTNode
+  AbsRefine_CounterExample::EvaluateInput(const ASTNode& original_input)
+  {
+    // Evaluate what CheckCounterExample will look at in the same pass.
+    ASTVec toEvaluate;
+    toEvaluate.push_back(original_input);
+    if (bm->UserFlags.check_counterexample_flag && !bm->ValidFlag)
+      {
+        const ASTVec& c = bm->GetAsserts();
+        toEvaluate.insert(toEvaluate.end(), c.begin(), c.end());
+        if (bm->GetQuery() != ASTUndefined)
+          toEvaluate.push_back(bm->GetQuery());
+      }
+    ComputeFormulasCompiled(toEvaluate);
+
+    ASTNode orig_result = ComputeFormulaUsingModel(original_input);
+    if (!(ASTTrue == orig_result || ASTFalse == orig_result))
+      FatalError("TopLevelSat: Original input must compute to "
+                 "true or false against model");
+    return orig_result;
+  }
+
   SOLVER_RETURN_TYPE
   AbsRefine_CounterExample::CallSAT_ResultCheck(SATSolver& SatSolver,
       const ASTNode& modified_input, const ASTNode& original_input, ToSATBase* tosat, bool refinement)
@@ -944,10 +1056,8 @@ namespace BEEV
         //check if the counterexample is good or not
         if (bm->counterexample_checking_during_refinement)
           bm->bvdiv_exception_occured = false;
-        ASTNode orig_result = ComputeFormulaUsingModel(original_input);
-        if (!(ASTTrue == orig_result || ASTFalse == orig_result))
-          FatalError("TopLevelSat: Original input must compute to "
-                     "true or false against model");
+
+        ASTNode orig_result = EvaluateInput(original_input);
 
         bm->GetRunTimes()->stop(RunTimes::CounterExampleGeneration);
 
@@ -975,7 +1085,9 @@ namespace BEEV
                 PrintCounterExample(true);
               }
 
-            assert (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS); // The array solver shouldn't have returned undecided..
+            // The array solver shouldn't have returned undecided, unless
+            // multiplications or divisions were abstracted.
+            assert (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS || hasMultDivAbstraction());
 
             return SOLVER_UNDECIDED;
           }
@@ -0,0 +1,856 @@
+#include "ModelEvaluator.h"
+
+namespace BEEV
+{
+  typedef ModelEvaluator::Word Word;
+
+  static const unsigned wordBits = 64;
+
+  static unsigned wordsFor(unsigned width)
+  {
+    return (width + wordBits - 1) / wordBits;
+  }
+
+  // The bits of the top word that are inside the width.
+  static Word topMask(unsigned width)
+  {
+    const unsigned r = width % wordBits;
+    return (r == 0) ? ~(Word) 0 : (((Word) 1) << r) - 1;
+  }
+
+  static bool bitOf(const Word* a, unsigned i)
+  {
+    return (a[i / wordBits] >> (i % wordBits)) & 1;
+  }
+
+  static bool isNegative(const Word* a, unsigned width)
+  {
+    return bitOf(a, width - 1);
+  }
+
+  static bool isZero(const Word* a, unsigned n)
+  {
+    for (unsigned i = 0; i < n; i++)
+      if (a[i] != 0)
+        return false;
+    return true;
+  }
+
+  static int compareUnsigned(const Word* a, const Word* b, unsigned n)
+  {
+    for (unsigned i = n; i-- > 0;)
+      if (a[i] != b[i])
+        return (a[i] < b[i]) ? -1 : 1;
+    return 0;
+  }
+
+  static int compareSigned(const Word* a, const Word* b, unsigned width)
+  {
+    const bool na = isNegative(a, width);
+    const bool nb = isNegative(b, width);
+    if (na != nb)
+      return na ? -1 : 1;
+    return compareUnsigned(a, b, wordsFor(width));
+  }
+
+  static void add(Word* r, const Word* a, const Word* b, unsigned width)
+  {
+    Word carry = 0;
+    for (unsigned i = 0; i < wordsFor(width); i++)
+      {
+        const Word s = a[i] + carry;
+        carry = (s < carry);
+        r[i] = s + b[i];
+        carry += (r[i] < s);
+      }
+    r[wordsFor(width) - 1] &= topMask(width);
+  }
+
+  static void negate(Word* r, const Word* a, unsigned width)
+  {
+    Word carry = 1;
+    for (unsigned i = 0; i < wordsFor(width); i++)
+      {
+        r[i] = ~a[i] + carry;
+        carry = (carry && r[i] == 0);
+      }
+    r[wordsFor(width) - 1] &= topMask(width);
+  }
+
+  static void subtract(Word* r, const Word* a, const Word* b, unsigned width)
+  {
+    vector<Word> nb(wordsFor(width));
+    negate(&nb[0], b, width);
+    add(r, a, &nb[0], width);
+  }
+
+  static void multiply(Word* r, const Word* a, const Word* b, unsigned width)
+  {
+    const unsigned n = wordsFor(width);
+    vector<Word> p(n, 0);
+    for (unsigned i = 0; i < n; i++)
+      {
+        unsigned __int128 carry = 0;
+        for (unsigned j = 0; i + j < n; j++)
+          {
+            carry += (unsigned __int128) a[i] * b[j] + p[i + j];
+            p[i + j] = (Word) carry;
+            carry >>= wordBits;
+          }
+      }
+    p[n - 1] &= topMask(width);
+    std::copy(p.begin(), p.end(), r);
+  }
+
+  // Long division, a bit at a time. "b" isn't zero.
+  static void divide(Word* q, Word* rem, const Word* a, const Word* b, unsigned width)
+  {
+    const unsigned n = wordsFor(width);
+    vector<Word> qq(n, 0), r(n, 0);
+    for (unsigned i = width; i-- > 0;)
+      {
+        // r = r*2 + bit i of a. r < b, so it fits in one more bit.
+        Word overflow = 0;
+        for (unsigned j = 0; j < n; j++)
+          {
+            const Word top = r[j] >> (wordBits - 1);
+            r[j] = (r[j] << 1) | overflow;
+            overflow = top;
+          }
+        r[0] |= bitOf(a, i);
+        const bool beyond = overflow || (width % wordBits != 0 && (r[n - 1] & ~topMask(width)) != 0);
+        if (beyond || compareUnsigned(&r[0], b, n) >= 0)
+          {
+            // Subtracting b brings it back under the width.
+            Word borrow = 0;
+            for (unsigned j = 0; j < n; j++)
+              {
+                const Word d = r[j] - b[j] - borrow;
+                borrow = (r[j] < b[j]) || (r[j] == b[j] && borrow);
+                r[j] = d;
+              }
+            r[n - 1] &= topMask(width);
+            qq[i / wordBits] |= ((Word) 1) << (i % wordBits);
+          }
+      }
+    if (q != NULL)
+      std::copy(qq.begin(), qq.end(), q);
+    if (rem != NULL)
+      std::copy(r.begin(), r.end(), rem);
+  }
+
+  // r gets "len" bits of "a" starting at bit "from". "a" is "aWidth" wide.
+  static void copyBits(Word* r, const Word* a, unsigned aWidth, unsigned from, unsigned len)
+  {
+    const unsigned an = wordsFor(aWidth);
+    for (unsigned j = 0; j < wordsFor(len); j++)
+      {
+        const unsigned bit = from + j * wordBits;
+        const unsigned idx = bit / wordBits;
+        const unsigned sh = bit % wordBits;
+        Word v = (idx < an) ? (a[idx] >> sh) : 0;
+        if (sh != 0 && idx + 1 < an)
+          v |= a[idx + 1] << (wordBits - sh);
+        r[j] = v;
+      }
+    r[wordsFor(len) - 1] &= topMask(len);
+  }
+
+  // Ors "len" bits of "a" into r starting at bit "to".
+  static void orBitsAt(Word* r, const Word* a, unsigned len, unsigned to)
+  {
+    const unsigned idx = to / wordBits;
+    const unsigned sh = to % wordBits;
+    const unsigned rn = wordsFor(to + len);
+    for (unsigned j = 0; j < wordsFor(len); j++)
+      {
+        r[idx + j] |= a[j] << sh;
+        if (sh != 0 && idx + j + 1 < rn)
+          r[idx + j + 1] |= a[j] >> (wordBits - sh);
+      }
+  }
+
+  // The shift amount, or the width if it's that or more.
+  static unsigned shiftAmount(const Word* s, unsigned width)
+  {
+    const unsigned n = wordsFor(width);
+    for (unsigned i = 1; i < n; i++)
+      if (s[i] != 0)
+        return width;
+    return (s[0] >= width) ? width : (unsigned) s[0];
+  }
+
+  unsigned ModelEvaluator::allocate(unsigned width)
+  {
+    const unsigned offset = words.size();
+    words.resize(offset + wordsFor(width), 0);
+    return offset;
+  }
+
+  void ModelEvaluator::loadConstant(const ASTNode& n, unsigned offset)
+  {
+    if (BOOLEAN_TYPE == n.GetType())
+      {
+        words[offset] = (n.GetKind() == TRUE);
+        return;
+      }
+
+    assert(BVCONST == n.GetKind());
+    const unsigned width = n.GetValueWidth();
+    CBV c = n.GetBVConst();
+    for (unsigned i = 0; i < wordsFor(width); i++)
+      {
+        const unsigned from = i * wordBits;
+        const unsigned len = std::min(wordBits, width - from);
+        // Read in two halves, as a chunk can be no bigger than a long.
+        Word v = CONSTANTBV::BitVector_Chunk_Read(c, std::min(32u, len), from);
+        if (len > 32)
+          v |= ((Word) CONSTANTBV::BitVector_Chunk_Read(c, len - 32, from + 32)) << 32;
+        words[offset + i] = v;
+      }
+  }
+
+  // The value of "n" in the model, if it has one. The same lookups as
+  // ComputeFormulaUsingModel and TermToConstTermUsingModel do.
+  bool ModelEvaluator::inModel(const ASTNode& n, ASTNode& value) const
+  {
+    const Kind k = n.GetKind();
+    if (SYMBOL != k && (!modelHasTerms || BOOLEAN_TYPE == n.GetType() || n.isConstant()))
+      return false;
+
+    ASTNodeMap::const_iterator it = model->find(n);
+    if (it == model->end())
+      return false;
+    value = it->second;
+    return true;
+  }
+
+  // The nodes whose values are needed to compute "n".
+  void ModelEvaluator::dependencies(const ASTNode& n, ASTVec& result) const
+  {
+    ASTNode value;
+    if (inModel(n, value))
+      {
+        if (!value.isConstant())
+          result.push_back(value);
+        return;
+      }
+
+    const Kind k = n.GetKind();
+    if (k == BVEXTRACT || k == BVSX || k == BVZX)
+      result.push_back(n[0]);
+    else
+      result.insert(result.end(), n.begin(), n.end());
+  }
+
+  static bool supported(const Kind k)
+  {
+    switch (k)
+      {
+      case BVNEG:
+      case BVUMINUS:
+      case BVAND:
+      case BVOR:
+      case BVXOR:
+      case BVPLUS:
+      case BVSUB:
+      case BVMULT:
+      case BVDIV:
+      case BVMOD:
+      case SBVDIV:
+      case SBVREM:
+      case SBVMOD:
+      case BVLEFTSHIFT:
+      case BVRIGHTSHIFT:
+      case BVSRSHIFT:
+      case BVEXTRACT:
+      case BVCONCAT:
+      case BVSX:
+      case BVZX:
+      case ITE:
+      case EQ:
+      case BVLT:
+      case BVLE:
+      case BVGT:
+      case BVGE:
+      case BVSLT:
+      case BVSLE:
+      case BVSGT:
+      case BVSGE:
+      case NOT:
+      case AND:
+      case OR:
+      case NAND:
+      case NOR:
+      case XOR:
+      case IFF:
+      case IMPLIES:
+        return true;
+      default:
+        return false;
+      }
+  }
+
+  bool ModelEvaluator::emit(const ASTNode& n)
+  {
+    const bool isFormula = (BOOLEAN_TYPE == n.GetType());
+    if (!isFormula && n.GetType() != BITVECTOR_TYPE)
+      return false; // arrays.
+
+    const unsigned width = isFormula ? 1 : n.GetValueWidth();
+
+    ASTNode value;
+    if (inModel(n, value))
+      {
+        if (value.isConstant())
+          {
+            offsets[n] = allocate(width);
+            loadConstant(value, offsets[n]);
+          }
+        else
+          offsets[n] = offsets.find(value)->second;
+        return true;
+      }
+
+    const Kind k = n.GetKind();
+    if (n.isConstant())
+      {
+        offsets[n] = allocate(width);
+        loadConstant(n, offsets[n]);
+        return true;
+      }
+
+    if (SYMBOL == k)
+      {
+        // Not in the model, so it was simplified out and can be anything.
+        offsets[n] = allocate(width);
+        inputs.push_back(n);
+        return true;
+      }
+
+    if (!supported(k))
+      return false;
+
+    ASTVec children;
+    dependencies(n, children);
+
+    Instruction in;
+    in.kind = k;
+    in.width = width;
+    in.childWidth = (BOOLEAN_TYPE == children[0].GetType()) ? 1 : children[0].GetValueWidth();
+    in.firstArg = args.size();
+    in.arity = children.size();
+    in.low = (k == BVEXTRACT) ? n[2].GetUnsignedConst() : 0;
+    for (unsigned i = 0; i < children.size(); i++)
+      args.push_back(offsets.find(children[i])->second);
+    in.result = allocate(width);
+    offsets[n] = in.result;
+    program.push_back(in);
+    return true;
+  }
+
+  bool ModelEvaluator::compile(const ASTVec& roots, const ASTNodeMap& m)
+  {
+    // Usually only symbols have values in the model, and then the other
+    // nodes needn't be looked up.
+    model = &m;
+    modelHasTerms = false;
+    for (ASTNodeMap::const_iterator it = m.begin(); it != m.end() && !modelHasTerms; it++)
+      modelHasTerms = (SYMBOL != it->first.GetKind());
+
+    // Nodes that are being compiled map to this.
+    const unsigned inProgress = ~0u;
+
+    vector<std::pair<ASTNode, bool> > stack;
+    for (unsigned i = 0; i < roots.size(); i++)
+      stack.push_back(std::make_pair(roots[i], false));
+
+    ASTVec deps;
+    while (!stack.empty())
+      {
+        const ASTNode n = stack.back().first;
+        const bool expanded = stack.back().second;
+
+        NodeAttribute<unsigned>::const_iterator it = offsets.find(n);
+        if (it != offsets.end() && it->second != inProgress)
+          {
+            stack.pop_back();
+            continue;
+          }
+
+        if (expanded)
+          {
+            stack.pop_back();
+            if (!emit(n))
+              return false;
+            continue;
+          }
+
+        stack.back().second = true;
+        offsets[n] = inProgress;
+
+        deps.clear();
+        dependencies(n, deps);
+        for (unsigned i = 0; i < deps.size(); i++)
+          {
+            NodeAttribute<unsigned>::const_iterator d = offsets.find(deps[i]);
+            if (d == offsets.end())
+              stack.push_back(std::make_pair(deps[i], false));
+            else if (d->second == inProgress)
+              return false; // The model refers to itself.
+          }
+      }
+    return true;
+  }
+
+  void ModelEvaluator::setInput(const ASTNode& symbol, const Word* value)
+  {
+    Word* r = &words[offsets.find(symbol)->second];
+    if (BOOLEAN_TYPE == symbol.GetType())
+      {
+        r[0] = value[0] & 1;
+        return;
+      }
+    const unsigned width = symbol.GetValueWidth();
+    const unsigned n = wordsFor(width);
+    std::copy(value, value + n, r);
+    r[n - 1] &= topMask(width);
+  }
+
+  ASTNode ModelEvaluator::getValue(const ASTNode& n) const
+  {
+    const Word* v = &words[offsets.find(n)->second];
+    if (BOOLEAN_TYPE == n.GetType())
+      return bm->CreateNode(v[0] != 0 ? TRUE : FALSE);
+
+    const unsigned width = n.GetValueWidth();
+    if (width <= wordBits)
+      return bm->CreateBVConst(width, (unsigned long long) v[0]);
+
+    CBV c = CONSTANTBV::BitVector_Create(width, true);
+    for (unsigned i = 0; i < wordsFor(width); i++)
+      {
+        const unsigned from = i * wordBits;
+        const unsigned len = std::min(wordBits, width - from);
+        CONSTANTBV::BitVector_Chunk_Store(c, std::min(32u, len), from, (unsigned long) (v[i] & 0xFFFFFFFF));
+        if (len > 32)
+          CONSTANTBV::BitVector_Chunk_Store(c, len - 32, from + 32, (unsigned long) (v[i] >> 32));
+      }
+    return bm->CreateBVConst(c, width);
+  }
+
+  bool ModelEvaluator::run()
+  {
+    const bool divByZeroIsOne = bm->UserFlags.division_by_zero_returns_one_flag;
+
+    for (vector<Instruction>::const_iterator p = program.begin(); p != program.end(); p++)
+      {
+        const Instruction& in = *p;
+        if (in.width > wordBits || in.childWidth > wordBits)
+          {
+            if (!runWide(in))
+              return false;
+            continue;
+          }
+
+        const unsigned* a = &args[in.firstArg];
+        const Word m = topMask(in.width);
+        Word& r = words[in.result];
+#define ARG(i) (words[a[(i)]])
+
+        switch (in.kind)
+          {
+        case BVNEG:
+          r = ~ARG(0) & m;
+          break;
+        case BVUMINUS:
+          r = (0 - ARG(0)) & m;
+          break;
+        case BVAND:
+        case AND:
+          {
+            Word v = ~(Word) 0;
+            for (unsigned i = 0; i < in.arity; i++)
+              v &= ARG(i);
+            r = v & m;
+            break;
+          }
+        case BVOR:
+        case OR:
+          {
+            Word v = 0;
+            for (unsigned i = 0; i < in.arity; i++)
+              v |= ARG(i);
+            r = v;
+            break;
+          }
+        case BVXOR:
+        case XOR:
+          {
+            Word v = 0;
+            for (unsigned i = 0; i < in.arity; i++)
+              v ^= ARG(i);
+            r = v;
+            break;
+          }
+        case NAND:
+          {
+            Word v = 1;
+            for (unsigned i = 0; i < in.arity; i++)
+              v &= ARG(i);
+            r = v ^ 1;
+            break;
+          }
+        case NOR:
+          {
+            Word v = 0;
+            for (unsigned i = 0; i < in.arity; i++)
+              v |= ARG(i);
+            r = v ^ 1;
+            break;
+          }
+        case NOT:
+          r = ARG(0) ^ 1;
+          break;
+        case IFF:
+          r = (ARG(0) == ARG(1));
+          break;
+        case IMPLIES:
+          r = (ARG(0) == 0) || (ARG(1) != 0);
+          break;
+        case BVPLUS:
+          {
+            Word v = 0;
+            for (unsigned i = 0; i < in.arity; i++)
+              v += ARG(i);
+            r = v & m;
+            break;
+          }
+        case BVMULT:
+          {
+            Word v = 1;
+            for (unsigned i = 0; i < in.arity; i++)
+              v *= ARG(i);
+            r = v & m;
+            break;
+          }
+        case BVSUB:
+          r = (ARG(0) - ARG(1)) & m;
+          break;
+        case BVDIV:
+        case BVMOD:
+          if (ARG(1) == 0)
+            {
+              if (!divByZeroIsOne)
+                return false;
+              r = (in.kind == BVDIV) ? 1 : ARG(0);
+            }
+          else
+            r = (in.kind == BVDIV) ? ARG(0) / ARG(1) : ARG(0) % ARG(1);
+          break;
+        case SBVDIV:
+        case SBVREM:
+        case SBVMOD:
+          {
+            const Word x = ARG(0), y = ARG(1);
+            const bool nx = (x >> (in.width - 1)) & 1;
+            const bool ny = (y >> (in.width - 1)) & 1;
+            if (y == 0)
+              {
+                if (!divByZeroIsOne)
+                  return false;
+                r = (in.kind == SBVDIV) ? (nx ? m : 1) : x;
+                break;
+              }
+            const Word ux = nx ? (0 - x) & m : x;
+            const Word uy = ny ? (0 - y) & m : y;
+            const Word q = ux / uy;
+            const Word rem = ux % uy;
+            if (in.kind == SBVDIV)
+              r = (nx != ny) ? (0 - q) & m : q;
+            else if (in.kind == SBVREM)
+              r = nx ? (0 - rem) & m : rem;
+            else if (!nx && !ny)
+              r = rem;
+            else if (nx && ny)
+              r = (0 - rem) & m;
+            else if (rem == 0)
+              r = 0;
+            else
+              r = ((nx ? (0 - rem) : rem) + y) & m;
+            break;
+          }
+        case BVLEFTSHIFT:
+        case BVRIGHTSHIFT:
+        case BVSRSHIFT:
+          {
+            const Word x = ARG(0), s = ARG(1);
+            const bool negative = (in.kind == BVSRSHIFT) && ((x >> (in.width - 1)) & 1);
+            if (s >= in.width)
+              r = negative ? m : 0;
+            else if (in.kind == BVLEFTSHIFT)
+              r = (x << s) & m;
+            else
+              r = (x >> s) | (negative ? (m & ~(m >> s)) : 0);
+            break;
+          }
+        case BVEXTRACT:
+          r = (ARG(0) >> in.low) & m;
+          break;
+        case BVCONCAT:
+          r = (ARG(0) << (in.width - in.childWidth)) | ARG(1);
+          break;
+        case BVZX:
+          r = ARG(0);
+          break;
+        case BVSX:
+          r = ARG(0);
+          if ((r >> (in.childWidth - 1)) & 1)
+            r |= m & ~topMask(in.childWidth);
+          break;
+        case ITE:
+          r = ARG(0) ? ARG(1) : ARG(2);
+          break;
+        case EQ:
+          r = (ARG(0) == ARG(1));
+          break;
+        case BVLT:
+          r = ARG(0) < ARG(1);
+          break;
+        case BVLE:
+          r = ARG(0) <= ARG(1);
+          break;
+        case BVGT:
+          r = ARG(0) > ARG(1);
+          break;
+        case BVGE:
+          r = ARG(0) >= ARG(1);
+          break;
+        case BVSLT:
+        case BVSLE:
+        case BVSGT:
+        case BVSGE:
+          {
+            // Flipping the sign bits makes it an unsigned comparison.
+            const Word sign = ((Word) 1) << (in.childWidth - 1);
+            const Word x = ARG(0) ^ sign, y = ARG(1) ^ sign;
+            if (in.kind == BVSLT)
+              r = x < y;
+            else if (in.kind == BVSLE)
+              r = x <= y;
+            else if (in.kind == BVSGT)
+              r = x > y;
+            else
+              r = x >= y;
+            break;
+          }
+        default:
+          FatalError("ModelEvaluator: kind not compiled");
+          }
+#undef ARG
+      }
+    return true;
+  }
+
+  // The same operations, on values that take more than one word.
+  bool ModelEvaluator::runWide(const Instruction& in)
+  {
+    const unsigned* a = &args[in.firstArg];
+    const unsigned n = wordsFor(in.width);
+    const unsigned cn = wordsFor(in.childWidth);
+    Word* r = &words[in.result];
+#define ARG(i) (&words[a[(i)]])
+
+    switch (in.kind)
+      {
+    case BVNEG:
+      for (unsigned i = 0; i < n; i++)
+        r[i] = ~ARG(0)[i];
+      r[n - 1] &= topMask(in.width);
+      break;
+    case BVUMINUS:
+      negate(r, ARG(0), in.width);
+      break;
+    case BVAND:
+    case BVOR:
+    case BVXOR:
+      for (unsigned i = 0; i < n; i++)
+        {
+          Word v = ARG(0)[i];
+          for (unsigned j = 1; j < in.arity; j++)
+            if (in.kind == BVAND)
+              v &= ARG(j)[i];
+            else if (in.kind == BVOR)
+              v |= ARG(j)[i];
+            else
+              v ^= ARG(j)[i];
+          r[i] = v;
+        }
+      break;
+    case BVPLUS:
+    case BVMULT:
+      {
+        vector<Word> v(ARG(0), ARG(0) + n);
+        for (unsigned j = 1; j < in.arity; j++)
+          if (in.kind == BVPLUS)
+            add(&v[0], &v[0], ARG(j), in.width);
+          else
+            multiply(&v[0], &v[0], ARG(j), in.width);
+        std::copy(v.begin(), v.end(), r);
+        break;
+      }
+    case BVSUB:
+      subtract(r, ARG(0), ARG(1), in.width);
+      break;
+    case BVDIV:
+    case BVMOD:
+    case SBVDIV:
+    case SBVREM:
+    case SBVMOD:
+      {
+        const Word* x = ARG(0);
+        const Word* y = ARG(1);
+        const bool signedDivision = (in.kind == SBVDIV || in.kind == SBVREM || in.kind == SBVMOD);
+        const bool nx = signedDivision && isNegative(x, in.width);
+        const bool ny = signedDivision && isNegative(y, in.width);
+
+        if (isZero(y, n))
+          {
+            if (!bm->UserFlags.division_by_zero_returns_one_flag)
+              return false;
+            if (in.kind == BVDIV || (in.kind == SBVDIV && !nx))
+              {
+                std::fill(r, r + n, 0);
+                r[0] = 1;
+              }
+            else if (in.kind == SBVDIV)
+              {
+                std::fill(r, r + n, ~(Word) 0);
+                r[n - 1] &= topMask(in.width);
+              }
+            else
+              std::copy(x, x + n, r);
+            break;
+          }
+
+        vector<Word> ux(x, x + n), uy(y, y + n), q(n), rem(n);
+        if (nx)
+          negate(&ux[0], x, in.width);
+        if (ny)
+          negate(&uy[0], y, in.width);
+        divide(&q[0], &rem[0], &ux[0], &uy[0], in.width);
+
+        if (in.kind == BVDIV || in.kind == BVMOD)
+          std::copy((in.kind == BVDIV ? q : rem).begin(), (in.kind == BVDIV ? q : rem).end(), r);
+        else if (in.kind == SBVDIV)
+          {
+            if (nx != ny)
+              negate(&q[0], &q[0], in.width);
+            std::copy(q.begin(), q.end(), r);
+          }
+        else if (in.kind == SBVREM || (nx && ny))
+          {
+            if (nx)
+              negate(&rem[0], &rem[0], in.width);
+            std::copy(rem.begin(), rem.end(), r);
+          }
+        else if (!nx && !ny)
+          std::copy(rem.begin(), rem.end(), r);
+        else if (isZero(&rem[0], n))
+          std::fill(r, r + n, 0);
+        else
+          {
+            if (nx)
+              negate(&rem[0], &rem[0], in.width);
+            add(r, &rem[0], y, in.width);
+          }
+        break;
+      }
+    case BVLEFTSHIFT:
+    case BVRIGHTSHIFT:
+    case BVSRSHIFT:
+      {
+        const Word* x = ARG(0);
+        const unsigned s = shiftAmount(ARG(1), in.width);
+        const bool negative = (in.kind == BVSRSHIFT) && isNegative(x, in.width);
+        vector<Word> v(n, 0);
+        if (in.kind == BVLEFTSHIFT)
+          {
+            if (s < in.width)
+              orBitsAt(&v[0], x, in.width - s, s);
+          }
+        else
+          {
+            if (s < in.width)
+              copyBits(&v[0], x, in.width, s, in.width - s);
+            if (negative)
+              for (unsigned i = in.width - s; i < in.width; i++)
+                v[i / wordBits] |= ((Word) 1) << (i % wordBits);
+          }
+        v[n - 1] &= topMask(in.width);
+        std::copy(v.begin(), v.end(), r);
+        break;
+      }
+    case BVEXTRACT:
+      copyBits(r, ARG(0), in.childWidth, in.low, in.width);
+      break;
+    case BVCONCAT:
+      {
+        const unsigned lowWidth = in.width - in.childWidth;
+        vector<Word> v(n, 0);
+        std::copy(ARG(1), ARG(1) + wordsFor(lowWidth), v.begin());
+        orBitsAt(&v[0], ARG(0), in.childWidth, lowWidth);
+        std::copy(v.begin(), v.end(), r);
+        break;
+      }
+    case BVZX:
+    case BVSX:
+      {
+        vector<Word> v(n, 0);
+        std::copy(ARG(0), ARG(0) + cn, v.begin());
+        if (in.kind == BVSX && isNegative(ARG(0), in.childWidth))
+          for (unsigned i = in.childWidth; i < in.width; i++)
+            v[i / wordBits] |= ((Word) 1) << (i % wordBits);
+        std::copy(v.begin(), v.end(), r);
+        break;
+      }
+    case ITE:
+      {
+        const Word* from = (*ARG(0) != 0) ? ARG(1) : ARG(2);
+        std::copy(from, from + n, r);
+        break;
+      }
+    case EQ:
+      r[0] = (compareUnsigned(ARG(0), ARG(1), cn) == 0);
+      break;
+    case BVLT:
+      r[0] = compareUnsigned(ARG(0), ARG(1), cn) < 0;
+      break;
+    case BVLE:
+      r[0] = compareUnsigned(ARG(0), ARG(1), cn) <= 0;
+      break;
+    case BVGT:
+      r[0] = compareUnsigned(ARG(0), ARG(1), cn) > 0;
+      break;
+    case BVGE:
+      r[0] = compareUnsigned(ARG(0), ARG(1), cn) >= 0;
+      break;
+    case BVSLT:
+      r[0] = compareSigned(ARG(0), ARG(1), in.childWidth) < 0;
+      break;
+    case BVSLE:
+      r[0] = compareSigned(ARG(0), ARG(1), in.childWidth) <= 0;
+      break;
+    case BVSGT:
+      r[0] = compareSigned(ARG(0), ARG(1), in.childWidth) > 0;
+      break;
+    case BVSGE:
+      r[0] = compareSigned(ARG(0), ARG(1), in.childWidth) >= 0;
+      break;
+    default:
+      FatalError("ModelEvaluator: kind not compiled");
+      }
+#undef ARG
+    return true;
+  }
+}
@@ -0,0 +1,98 @@
+// -*- c++ -*-
+/*
+ * Evaluates formulas against a model without creating AST nodes. The DAG
+ * is lowered once into a flat array of instructions, in the order that
+ * they must be run, over a buffer of 64-bit words. Each node's value takes
+ * (width+63)/64 words, and formulas take one word that is zero or one.
+ * Running the program is then a single pass that mostly does a machine
+ * operation per node.
+ *
+ * The values of the symbols come from the model given to compile(). A
+ * symbol whose value is a term (from the solver map) shares the value of
+ * that term. A symbol that isn't in the model is an input, which is zero
+ * unless it's set.
+ */
+#ifndef MODELEVALUATOR_H
+#define MODELEVALUATOR_H
+
+#include "../AST/AST.h"
+#include "../AST/NodeAttribute.h"
+#include "../STPManager/STPManager.h"
+#include "../boost/noncopyable.hpp"
+
+namespace BEEV
+{
+  class ModelEvaluator : boost::noncopyable
+  {
+  public:
+    typedef uint64_t Word;
+
+  private:
+    struct Instruction
+    {
+      Kind kind;
+      unsigned width;      // Of the result. One for formulas.
+      unsigned childWidth; // Of the first child.
+      unsigned result;     // Offset of the result in "words".
+      unsigned firstArg;   // Position in "args" of the first child's offset.
+      unsigned arity;
+      unsigned low;        // The lowest bit that BVEXTRACT takes.
+    };
+
+    STPMgr* bm;
+    vector<Instruction> program;
+    vector<unsigned> args;
+    vector<Word> words;
+
+    // Where the value of each compiled node is kept.
+    NodeAttribute<unsigned> offsets;
+    ASTVec inputs;
+
+    const ASTNodeMap* model;
+    bool modelHasTerms;
+
+    bool inModel(const ASTNode& n, ASTNode& value) const;
+    void dependencies(const ASTNode& n, ASTVec& result) const;
+
+    unsigned allocate(unsigned width);
+    void loadConstant(const ASTNode& n, unsigned offset);
+    bool emit(const ASTNode& n);
+
+    bool runWide(const Instruction& in);
+
+  public:
+    ModelEvaluator(STPMgr* b) :
+      bm(b), model(NULL), modelHasTerms(false)
+    {
+    }
+
+    // Lowers the DAG below "roots". Returns false if it contains something
+    // that can't be evaluated this way, e.g. array operations.
+    bool compile(const ASTVec& roots, const ASTNodeMap& model);
+
+    // The symbols that weren't in the model.
+    const ASTVec& getInputs() const
+    {
+      return inputs;
+    }
+
+    // Sets an input from (width+63)/64 words, least significant first.
+    void setInput(const ASTNode& symbol, const Word* value);
+
+    // Returns false if the model can't be evaluated this way. That's only
+    // when a division by zero is an error.
+    bool run();
+
+    // The value of a compiled formula, after run().
+    bool isTrue(const ASTNode& formula) const
+    {
+      assert(BOOLEAN_TYPE == formula.GetType());
+      return words[offsets.find(formula)->second] != 0;
+    }
+
+    // The value of a compiled node, after run(), as a constant.
+    ASTNode getValue(const ASTNode& n) const;
+  };
+}
+
+#endif
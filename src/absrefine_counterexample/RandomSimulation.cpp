@@ -0,0 +1,150 @@
+// -*- c++ -*-
+/*
+ * Looks for a model by evaluating the simplified formula on candidate
+ * assignments before anything is bit-blasted. Many satisfiable queries have
+ * lots of models, and then one of a few hundred mostly random candidates
+ * often satisfies them, which is much cheaper than bit-blasting, generating
+ * CNF and calling the SAT solver.
+ */
+
+#include <cstdlib>
+#include "AbsRefine_CounterExample.h"
+#include "ModelEvaluator.h"
+#include "../simplifier/constantBitP/ConstantBitPropagation.h"
+#include "../simplifier/constantBitP/NodeToFixedBitsMap.h"
+
+namespace BEEV
+{
+  using simplifier::constantBitP::ConstantBitPropagation;
+  using simplifier::constantBitP::FixedBits;
+
+  typedef ModelEvaluator::Word Word;
+
+  // Candidates are tried this many at a time.
+  static const unsigned batchSize = 64;
+
+  // xorshift64*, so that the candidates are the same each run.
+  static Word nextRandom(Word& state)
+  {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+  }
+
+  // Word "w" of the value of candidate "c". The first candidates are
+  // zero, all ones, and one. After those, half are uniformly random and
+  // half are small numbers, which satisfy bounds and the like more often.
+  static Word candidateWord(unsigned c, unsigned w, Word& state)
+  {
+    switch (c)
+      {
+    case 0:
+      return 0;
+    case 1:
+      return ~(Word) 0;
+    case 2:
+      return (w == 0) ? 1 : 0;
+      }
+
+    const Word r = nextRandom(state);
+    if (c % 2 == 0)
+      return r;
+    if (w != 0)
+      return 0;
+    return r >> (nextRandom(state) % 64);
+  }
+
+  SOLVER_RETURN_TYPE
+  AbsRefine_CounterExample::RandomSimulation(const ASTNode& modified_input, const ASTNode& original_input,
+      ConstantBitPropagation* cb)
+  {
+    if (!bm->UserFlags.isSet("random-simulation", "1") || !bm->UserFlags.construct_counterexample_flag)
+      return SOLVER_UNDECIDED;
+
+    // Array reads are given their values from the SAT solver's model.
+    if (ASTFalse == modified_input || !ArrayTransform->arrayToIndexToRead.empty())
+      return SOLVER_UNDECIDED;
+
+    const unsigned rounds = atoi(bm->UserFlags.get("random-simulation-rounds", "4").c_str());
+    if (rounds == 0)
+      return SOLVER_UNDECIDED;
+
+    bm->GetRunTimes()->start(RunTimes::RandomSimulation);
+
+    CounterExampleMap.clear();
+    ComputeFormulaMap.clear();
+    CopySolverMap_To_CounterExample();
+
+    ModelEvaluator evaluator(bm);
+    if (!evaluator.compile(ASTVec(1, modified_input), CounterExampleMap))
+      {
+        CounterExampleMap.clear();
+        bm->GetRunTimes()->stop(RunTimes::RandomSimulation);
+        return SOLVER_UNDECIDED;
+      }
+
+    // The bits that constant bit propagation fixed, which every model has.
+    const ASTVec& inputs = evaluator.getInputs();
+    vector<FixedBits*> fixed(inputs.size(), (FixedBits*) NULL);
+    if (cb != NULL && cb->fixedMap != NULL)
+      for (unsigned i = 0; i < inputs.size(); i++)
+        {
+          simplifier::constantBitP::NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it =
+              cb->fixedMap->map->find(inputs[i]);
+          if (it != cb->fixedMap->map->end())
+            fixed[i] = it->second;
+        }
+
+    Word state = 0x9E3779B97F4A7C15ULL;
+    vector<Word> value;
+    bool found = false;
+    for (unsigned c = 0; c < rounds * batchSize && !found; c++)
+      {
+        for (unsigned i = 0; i < inputs.size(); i++)
+          {
+            const unsigned width = std::max(1u, inputs[i].GetValueWidth());
+            value.resize((width + 63) / 64);
+            for (unsigned w = 0; w < value.size(); w++)
+              {
+                value[w] = candidateWord(c, w, state);
+                if (fixed[i] != NULL)
+                  {
+                    const Word mask = fixed[i]->getFixedWord(w);
+                    value[w] = (value[w] & ~mask) | (fixed[i]->getValueWord(w) & mask);
+                  }
+              }
+            evaluator.setInput(inputs[i], &value[0]);
+          }
+
+        if (!evaluator.run())
+          break; // A division by zero, which is an error.
+        found = evaluator.isTrue(modified_input);
+      }
+
+    if (found)
+      {
+        for (ASTVec::const_iterator it = inputs.begin(); it != inputs.end(); it++)
+          CounterExampleMap[*it] = evaluator.getValue(*it);
+
+        // The simplified formula is true, so the original input should be.
+        if (bm->counterexample_checking_during_refinement)
+          bm->bvdiv_exception_occured = false;
+        found = (ASTTrue == EvaluateInput(original_input));
+      }
+
+    if (!found)
+      {
+        CounterExampleMap.clear();
+        ComputeFormulaMap.clear();
+        bm->GetRunTimes()->stop(RunTimes::RandomSimulation);
+        return SOLVER_UNDECIDED;
+      }
+
+    bm->GetRunTimes()->addCount(RunTimes::SolvedByRandomSimulation);
+    bm->GetRunTimes()->stop(RunTimes::RandomSimulation);
+
+    CheckAndPrintCounterExample();
+    return SOLVER_INVALID;
+  }
+}
@@ -10,6 +10,9 @@
 
 #include <stdlib.h>
 #include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include "fdstream.h"
 #include "../printer/printers.h"
 #include "../cpp_interface/cpp_interface.h"
@@ -26,34 +29,58 @@ typedef BEEV::BVSolver*                  bvsolverstar;
 typedef BEEV::AbsRefine_CounterExample * ctrexamplestar;
 typedef BEEV::ASTVec                     nodelist;
 typedef BEEV::CompleteCounterExample*    CompleteCEStar;
-BEEV::ASTVec *decls = NULL;
-SimplifyingNodeFactory *simpNF = NULL;
 //vector<BEEV::ASTNode *> created_exprs;
 
-// persist holds a copy of ASTNodes so that the reference count of
-// objects we have pointers to doesn't hit zero.
-vector<BEEV::ASTNode*> persist;
-bool cinterface_exprdelete_on_flag = true;
+// Everything that a VC owns. VCs share nothing, so different threads
+// can use different VCs at the same time.
+struct ValidityChecker
+{
+  stpstar stp;
+
+  // The declared variables, for printing.
+  BEEV::ASTVec decls;
+
+  SimplifyingNodeFactory *simpNF;
+
+  // persist holds a copy of ASTNodes so that the reference count of
+  // objects we have pointers to doesn't hit zero.
+  vector<BEEV::ASTNode*> persist;
+  bool exprdelete_on_flag;
+};
+typedef ValidityChecker*                 vcstar;
+
+// The parsers are generated by flex and bison, and keep their state in
+// globals (including BEEV::ParserBM), so only one VC can parse at a time.
+static pthread_mutex_t parser_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// BitVector_Boot() sets up tables for the whole process.
+static pthread_once_t boot_once = PTHREAD_ONCE_INIT;
+static CONSTANTBV::ErrCode boot_result;
+
+static void boot()
+{
+  boot_result = CONSTANTBV::BitVector_Boot();
+}
 
 // GLOBAL FUNCTION: parser
 extern int cvcparse(void*);
 extern int smtparse(void*);
 
 void vc_setFlags(VC vc, char c, int param_value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   process_argument(c, b);
 }
 
 void vc_setFlag(VC vc, char c) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   process_argument(c, b);
 }
 
 void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value) {
-    bmstar b = (bmstar)(((stpstar)vc)->bm);
+    bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
     switch (f) {
   case EXPRDELETE:
-    cinterface_exprdelete_on_flag = param_value != 0;
+    ((vcstar)vc)->exprdelete_on_flag = param_value != 0;
     break;
   case MS:
       b->UserFlags.solver_to_use = BEEV::UserDefinedFlags::MINISAT_SOLVER;
@@ -67,6 +94,9 @@ void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value) {
   case MSP:
       b->UserFlags.solver_to_use = BEEV::UserDefinedFlags::MINISAT_PROPAGATORS;
       break;
+  case INCREMENTAL:
+      b->UserFlags.incremental_flag = param_value != 0;
+      break;
   default:
     BEEV::FatalError("C_interface: vc_setInterfaceFlags: Unrecognized flag\n");
     break;
@@ -75,13 +105,14 @@ void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value) {
 
 void make_division_total(VC vc)
 {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   b->UserFlags.division_by_zero_returns_one_flag = true;
 }
 
-//Create a validity Checker. This is the global STPMgr
+//Create a validity Checker. Each has its own STPMgr
 VC vc_createValidityChecker(void) {
-  CONSTANTBV::ErrCode c = CONSTANTBV::BitVector_Boot();
+  pthread_once(&boot_once, boot);
+  CONSTANTBV::ErrCode c = boot_result;
   if(0 != c) {
     cout << CONSTANTBV::BitVector_Error(c) << endl;
     return 0;
@@ -99,20 +130,20 @@ VC vc_createValidityChecker(void) {
                                        arrayTransformer
                                        );
 
-  BEEV::ParserBM = bm;
   stpstar stp =
     new BEEV::STP(bm, simp, 
                   bvsolver, arrayTransformer, 
                   tosat, Ctr_Example);
   
-  simpNF = new SimplifyingNodeFactory(*(bm->hashingNodeFactory), *bm);
-  bm->defaultNodeFactory = simpNF;
+  vcstar vc = new ValidityChecker();
+  vc->stp = stp;
+  vc->simpNF = new SimplifyingNodeFactory(*(bm->hashingNodeFactory), *bm);
+  vc->exprdelete_on_flag = true;
+  bm->defaultNodeFactory = vc->simpNF;
 
-  BEEV::GlobalSTP = stp;
-  decls = new BEEV::ASTVec();
   //created_exprs.clear();
-  vc_setFlags(stp,'d');
-  return (VC)stp;
+  vc_setFlags(vc,'d');
+  return (VC)vc;
 }
 
 // Expr I/O
@@ -139,7 +170,7 @@ char * vc_printSMTLIB(VC vc, Expr e)
 // prints Expr 'e' to stdout as C code
 void vc_printExprCCode(VC vc, Expr e) {
   BEEV::ASTNode q = (*(nodestar)e);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   // print variable declarations
   BEEV::ASTVec declsFromParser = (nodelist)b->ListOfDeclaredVars;
@@ -175,8 +206,9 @@ void vc_printExprFile(VC vc, Expr e, int fd) {
 }
 
 static void vc_printVarDeclsToStream(VC vc, ostream &os) {
-  for(BEEV::ASTVec::iterator i = decls->begin(),
-        iend=decls->end();i!=iend;i++) {
+  BEEV::ASTVec& decls = ((vcstar)vc)->decls;
+  for(BEEV::ASTVec::iterator i = decls.begin(),
+        iend=decls.end();i!=iend;i++) {
     node a = *i;
     switch(a.GetType()) {
     case BEEV::BITVECTOR_TYPE:
@@ -212,11 +244,11 @@ void vc_printVarDecls(VC vc) {
 }
 
 void vc_clearDecls(VC vc) {
-  decls->clear();
+  ((vcstar)vc)->decls.clear();
 }
 
 static void vc_printAssertsToStream(VC vc, ostream &os, int simplify_print) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   BEEV::ASTVec v = b->GetAsserts();
   BEEV::Simplifier * simp = new BEEV::Simplifier(b);
   for(BEEV::ASTVec::iterator i=v.begin(),iend=v.end();i!=iend;i++) {
@@ -245,7 +277,7 @@ void vc_printQueryStateToBuffer(VC vc, Expr e,
   assert(e);
   assert(buf);
   assert(len);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   BEEV::Simplifier * simp = new BEEV::Simplifier(b);
 
   // formate the state of the query
@@ -281,8 +313,8 @@ void vc_printCounterExampleToBuffer(VC vc, char **buf, unsigned long *len) {
   assert(vc);
   assert(buf);
   assert(len);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
 
   // formate the state of the query
   std::ostringstream os;
@@ -308,7 +340,7 @@ void vc_printCounterExampleToBuffer(VC vc, char **buf, unsigned long *len) {
 
 void vc_printExprToBuffer(VC vc, Expr e, char **buf, unsigned long * len) {
   stringstream os;
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   BEEV::ASTNode q = *((nodestar)e);
   // b->Begin_RemoveWrites = true;
   //   BEEV::ASTNode q = b->SimplifyFormula_TopLevel(*((nodestar)e),false);
@@ -325,7 +357,7 @@ void vc_printExprToBuffer(VC vc, Expr e, char **buf, unsigned long * len) {
 
 void vc_printQuery(VC vc){
   ostream& os = std::cout;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   os << "QUERY(";
   //b->Begin_RemoveWrites = true;
   //BEEV::ASTNode q = b->SimplifyFormula_TopLevel(b->GetQuery(),false);
@@ -336,11 +368,11 @@ void vc_printQuery(VC vc){
   os << ");" << endl;
 }
 
-nodestar persistNode(node n)
+static nodestar persistNode(VC vc, node n)
 {
   nodestar np = new node(n);
-  if (cinterface_exprdelete_on_flag)
-    persist.push_back(np);
+  if (((vcstar)vc)->exprdelete_on_flag)
+    ((vcstar)vc)->persist.push_back(np);
   return np;
 }
 
@@ -350,7 +382,7 @@ nodestar persistNode(node n)
 /////////////////////////////////////////////////////////////////////////////
 //! Create an array type
 Type vc_arrayType(VC vc, Type typeIndex, Type typeData) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar ti = (nodestar)typeIndex;
   nodestar td = (nodestar)typeData;
 
@@ -368,12 +400,12 @@ Type vc_arrayType(VC vc, Type typeIndex, Type typeData) {
     }
   node output = b->CreateNode(BEEV::ARRAY,(*ti)[0],(*td)[0]);
 
-  return persistNode(output);
+  return persistNode(vc, output);
 }
 
 //! Create an expression for the value of array at the given index
 Expr vc_readExpr(VC vc, Expr array, Expr index) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)array;
   nodestar i = (nodestar)index;
 
@@ -389,7 +421,7 @@ Expr vc_readExpr(VC vc, Expr array, Expr index) {
 
 // //! Array update; equivalent to "array WITH [index] := newValue"
 Expr vc_writeExpr(VC vc, Expr array, Expr index, Expr newValue) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)array;
   nodestar i = (nodestar)index;
   nodestar n = (nodestar)newValue;
@@ -413,7 +445,7 @@ Expr vc_writeExpr(VC vc, Expr array, Expr index, Expr newValue) {
 /*! The formula must have Boolean type. */
 void vc_assertFormula(VC vc, Expr e) {
   nodestar a = (nodestar)e;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   if(!BEEV::is_Form_kind(a->GetKind()))
     BEEV::FatalError("Trying to assert a NON formula: ",*a);
@@ -422,9 +454,30 @@ void vc_assertFormula(VC vc, Expr e) {
   b->AddAssert(*a);
 }
 
-void soft_time_out(int ignored)
+// Sets a VC's soft timeout flag unless the query finishes first. A
+// timer signal would be shared by the whole process, so each timed
+// query gets a thread of its own to do this.
+struct Watchdog
 {
-  BEEV::ParserBM->soft_timeout_expired = true;
+  pthread_mutex_t lock;
+  pthread_cond_t finished_cond;
+  bool finished;
+  timespec deadline;
+  volatile bool* expired;
+};
+
+static void* soft_time_out(void* arg)
+{
+  Watchdog* w = (Watchdog*)arg;
+  pthread_mutex_lock(&w->lock);
+  while (!w->finished)
+    if (pthread_cond_timedwait(&w->finished_cond, &w->lock, &w->deadline) == ETIMEDOUT)
+      {
+        *w->expired = true;
+        break;
+      }
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
 }
 
 //! Check validity of e in the current context. e must be a FORMULA
@@ -447,19 +500,25 @@ int vc_query(VC vc, Expr e)
 
 int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
   nodestar a = (nodestar)e;
-  stpstar stp = ((stpstar)vc);
+  stpstar stp = ((vcstar)vc)->stp;
   bmstar b = (bmstar)(stp->bm);
 
-  assert(!BEEV::ParserBM->soft_timeout_expired);
+  assert(!b->soft_timeout_expired);
+  Watchdog watchdog;
+  pthread_t watchdog_thread;
   if (timeout_ms != -1)
     {
-      itimerval timeout;
-      signal(SIGVTALRM, soft_time_out);
-      timeout.it_interval.tv_usec = 0;
-      timeout.it_interval.tv_sec  = 0;
-      timeout.it_value.tv_usec    = 1000 * (timeout_ms % 1000);
-      timeout.it_value.tv_sec     = timeout_ms / 1000;
-      setitimer(ITIMER_VIRTUAL, &timeout, NULL);
+      timeval now;
+      gettimeofday(&now, NULL);
+      long usec = now.tv_usec + 1000L * (timeout_ms % 1000);
+      watchdog.deadline.tv_sec  = now.tv_sec + timeout_ms / 1000 + usec / 1000000;
+      watchdog.deadline.tv_nsec = 1000 * (usec % 1000000);
+      watchdog.finished = false;
+      watchdog.expired = &b->soft_timeout_expired;
+      pthread_mutex_init(&watchdog.lock, NULL);
+      pthread_cond_init(&watchdog.finished_cond, NULL);
+      if (0 != pthread_create(&watchdog_thread, NULL, soft_time_out, &watchdog))
+        BEEV::FatalError("CInterface: couldn't start the timeout thread");
     }
 
   if(!BEEV::is_Form_kind(a->GetKind())) 
@@ -492,9 +551,15 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
 
   if (timeout_ms !=-1)
     {
-      // Reset the timer.
-      setitimer(ITIMER_VIRTUAL, NULL, NULL);
-      BEEV::ParserBM->soft_timeout_expired = false;
+      // Stop the watchdog.
+      pthread_mutex_lock(&watchdog.lock);
+      watchdog.finished = true;
+      pthread_cond_signal(&watchdog.finished_cond);
+      pthread_mutex_unlock(&watchdog.lock);
+      pthread_join(watchdog_thread, NULL);
+      pthread_cond_destroy(&watchdog.finished_cond);
+      pthread_mutex_destroy(&watchdog.lock);
+      b->soft_timeout_expired = false;
     }
 
   return output;
@@ -502,7 +567,7 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
 
 // int vc_absRefineQuery(VC vc, Expr e) {
 //   nodestar a = (nodestar)e;
-//   bmstar b   = (bmstar)(((stpstar)vc)->bm);
+//   bmstar b   = (bmstar)(((vcstar)vc)->stp->bm);
 
 //   if(!BEEV::is_Form_kind(a->GetKind()))
 //     BEEV::FatalError("CInterface: Trying to QUERY a NON formula: ",*a);
@@ -525,19 +590,19 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
 // }
 
 void vc_push(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ((stpstar)vc)->ClearAllTables();
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ((vcstar)vc)->stp->ClearAllTables();
   b->Push();
 }
 
 void vc_pop(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   b->Pop();
 }
 
 void vc_printCounterExample(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);
 
   bool currentPrint = b->UserFlags.print_counterexample_flag;
     b->UserFlags.print_counterexample_flag = true;
@@ -557,8 +622,8 @@ void vc_printCounterExample(VC vc) {
 
 Expr vc_getCounterExample(VC vc, Expr e) {
   nodestar a = (nodestar)e;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
 
   bool t = false;
   if(ce->CounterExampleSize())
@@ -570,8 +635,8 @@ Expr vc_getCounterExample(VC vc, Expr e) {
 
 void vc_getCounterExampleArray(VC vc, Expr e, Expr **indices, Expr **values, int *size) {
   nodestar a = (nodestar)e;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
 
   bool t = false;
   if(ce->CounterExampleSize())
@@ -590,15 +655,15 @@ void vc_getCounterExampleArray(VC vc, Expr e, Expr **indices, Expr **values, int
 }
 
 int vc_counterexample_size(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
 
   return ce->CounterExampleSize();
 }
 
 WholeCounterExample vc_getWholeCounterExample(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
 
   CompleteCEStar c =
     new BEEV::CompleteCounterExample(ce->GetCompleteCounterExample(),
@@ -607,7 +672,7 @@ WholeCounterExample vc_getWholeCounterExample(VC vc) {
 }
 
 Expr vc_getTermFromCounterExample(VC vc, Expr e, WholeCounterExample cc) {
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar n = (nodestar)e;
   CompleteCEStar c = (CompleteCEStar)cc;
 
@@ -639,7 +704,7 @@ int vc_getBVLength(VC vc, Expr ex) {
 /*! The type cannot be a function type. */
 Expr vc_varExpr1(VC vc, const char* name,
                  int indexwidth, int valuewidth) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   node o = b->CreateSymbol(name,indexwidth,valuewidth);
 
@@ -648,12 +713,12 @@ Expr vc_varExpr1(VC vc, const char* name,
   assert(BVTypeCheck(*output));
 
   //store the decls in a vector for printing purposes
-  decls->push_back(o);
+  ((vcstar)vc)->decls.push_back(o);
   return output;
 }
 
 Expr vc_varExpr(VC vc, const char * name, Type type) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)type;
 
   unsigned indexWidth;
@@ -684,14 +749,14 @@ Expr vc_varExpr(VC vc, const char * name, Type type) {
   assert(BVTypeCheck(*output));
 
   //store the decls in a vector for printing purposes
-  decls->push_back(o);
+  ((vcstar)vc)->decls.push_back(o);
   return output;
 }
 
 //! Create an equality expression.  The two children must have the
 //same type.
 Expr vc_eqExpr(VC vc, Expr ccc0, Expr ccc1) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   nodestar a = (nodestar)ccc0;
   nodestar aa = (nodestar)ccc1;
@@ -705,7 +770,7 @@ Expr vc_eqExpr(VC vc, Expr ccc0, Expr ccc1) {
 }
 
 Expr vc_boolType(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   node o = b->CreateNode(BEEV::BOOLEAN);
   nodestar output = new node(o);
@@ -719,7 +784,7 @@ Expr vc_boolType(VC vc) {
 // The following functions create Boolean expressions.  The children
 // provided as arguments must be of type Boolean.
 Expr vc_trueExpr(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   node c = b->CreateNode(BEEV::TRUE);
 
   nodestar d = new node(c);
@@ -728,7 +793,7 @@ Expr vc_trueExpr(VC vc) {
 }
 
 Expr vc_falseExpr(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   node c = b->CreateNode(BEEV::FALSE);
 
   nodestar d = new node(c);
@@ -737,7 +802,7 @@ Expr vc_falseExpr(VC vc) {
 }
 
 Expr vc_notExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
 
   node o = b->CreateNode(BEEV::NOT,*a);
@@ -749,7 +814,7 @@ Expr vc_notExpr(VC vc, Expr ccc) {
 }
 
 Expr vc_andExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -762,7 +827,7 @@ Expr vc_andExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_orExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -774,7 +839,7 @@ Expr vc_orExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_xorExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -787,7 +852,7 @@ Expr vc_xorExpr(VC vc, Expr left, Expr right) {
 
 
 Expr vc_andExprN(VC vc, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -804,7 +869,7 @@ Expr vc_andExprN(VC vc, Expr* cc, int n) {
 
 
 Expr vc_orExprN(VC vc, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -820,7 +885,7 @@ Expr vc_orExprN(VC vc, Expr* cc, int n) {
 }
 
 Expr vc_bvPlusExprN(VC vc, int n_bits, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -837,7 +902,7 @@ Expr vc_bvPlusExprN(VC vc, int n_bits, Expr* cc, int n) {
 
 
 Expr vc_iteExpr(VC vc, Expr cond, Expr thenpart, Expr elsepart){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar c = (nodestar)cond;
   nodestar t = (nodestar)thenpart;
   nodestar e = (nodestar)elsepart;
@@ -861,7 +926,7 @@ Expr vc_iteExpr(VC vc, Expr cond, Expr thenpart, Expr elsepart){
 }
 
 Expr vc_impliesExpr(VC vc, Expr antecedent, Expr consequent){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar c = (nodestar)antecedent;
   nodestar t = (nodestar)consequent;
 
@@ -877,7 +942,7 @@ Expr vc_impliesExpr(VC vc, Expr antecedent, Expr consequent){
 }
 
 Expr vc_iffExpr(VC vc, Expr e0, Expr e1){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar c = (nodestar)e0;
   nodestar t = (nodestar)e1;
 
@@ -893,7 +958,7 @@ Expr vc_iffExpr(VC vc, Expr e0, Expr e1){
 }
 
 Expr vc_boolToBVExpr(VC vc, Expr form) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar c = (nodestar)form;
 
   assert(BVTypeCheck(*c));
@@ -915,7 +980,7 @@ Expr vc_boolToBVExpr(VC vc, Expr form) {
 }
 
 Expr vc_paramBoolExpr(VC vc, Expr boolvar, Expr parameter){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar c = (nodestar)boolvar;
   nodestar t = (nodestar)parameter;
 
@@ -935,7 +1000,7 @@ Expr vc_paramBoolExpr(VC vc, Expr boolvar, Expr parameter){
 // BITVECTOR EXPR Creation methods                                         //
 /////////////////////////////////////////////////////////////////////////////
 Type vc_bvType(VC vc, int num_bits) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   if(!(0 < num_bits))
     {
@@ -946,7 +1011,7 @@ Type vc_bvType(VC vc, int num_bits) {
 
   node e = b->CreateBVConst(32, num_bits);
   node output = (b->CreateNode(BEEV::BITVECTOR,e));
-  return persistNode(output);
+  return persistNode(vc, output);
 }
 
 Type vc_bv32Type(VC vc) {
@@ -957,7 +1022,7 @@ Expr vc_bvConstExprFromDecStr(VC vc,
                               int width, 
                               const char* decimalInput ) 
 {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   string str(decimalInput);
   node n = b->CreateBVConst(str, 10, width);
   assert(BVTypeCheck(n));
@@ -967,7 +1032,7 @@ Expr vc_bvConstExprFromDecStr(VC vc,
 
 
 Expr vc_bvConstExprFromStr(VC vc, const char* binary_repr) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   node n = b->CreateBVConst(binary_repr,2);
   assert(BVTypeCheck(n));
@@ -979,7 +1044,7 @@ Expr vc_bvConstExprFromStr(VC vc, const char* binary_repr) {
 Expr vc_bvConstExprFromInt(VC vc,
                            int n_bits,
                            unsigned int value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   unsigned long long int v = (unsigned long long int)value;
   unsigned long long int max_n_bits = 0xFFFFFFFFFFFFFFFFULL >> 64-n_bits;
@@ -991,13 +1056,13 @@ Expr vc_bvConstExprFromInt(VC vc,
   }
   node n = b->CreateBVConst(n_bits, v);
   assert(BVTypeCheck(n));
-  return persistNode(n);
+  return persistNode(vc, n);
 }
 
 Expr vc_bvConstExprFromLL(VC vc,
                           int n_bits,
                           unsigned long long value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
   node n = b->CreateBVConst(n_bits, value);
   assert(BVTypeCheck(n));
@@ -1007,7 +1072,7 @@ Expr vc_bvConstExprFromLL(VC vc,
 }
 
 Expr vc_bvConcatExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -1023,7 +1088,7 @@ Expr vc_bvConcatExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr createBinaryTerm(VC vc, int n_bits, Kind k, Expr left, Expr right){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -1084,7 +1149,7 @@ Expr vc_bv32MultExpr(VC vc, Expr left, Expr right) {
 
 Expr createBinaryNode(VC vc, Kind k, Expr left, Expr right)
 {
-    bmstar b = (bmstar)(((stpstar)vc)->bm);
+    bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
     nodestar l = (nodestar)left;
     nodestar r = (nodestar)right;
     assert(BVTypeCheck(*l));
@@ -1141,7 +1206,7 @@ Expr vc_bvSignedRightShiftExprExpr(VC vc,int n_bits, Expr left, Expr right)
 
 
 Expr vc_bvUMinusExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1168,7 +1233,7 @@ Expr vc_bvXorExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_bvNotExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
 
   assert(BVTypeCheck(*a));
@@ -1180,7 +1245,7 @@ Expr vc_bvNotExpr(VC vc, Expr ccc) {
 }
 
 Expr vc_bvLeftShiftExpr(VC vc, int sh_amt, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1200,7 +1265,7 @@ Expr vc_bvLeftShiftExpr(VC vc, int sh_amt, Expr ccc) {
 }
 
 Expr vc_bvRightShiftExpr(VC vc, int sh_amt, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1334,7 +1399,7 @@ Expr vc_bvVar32RightShiftExpr(VC vc, Expr sh_amt, Expr child) {
 }
 
 Expr vc_bvExtract(VC vc, Expr ccc, int hi_num, int low_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1348,7 +1413,7 @@ Expr vc_bvExtract(VC vc, Expr ccc, int hi_num, int low_num) {
 }
 
 Expr vc_bvBoolExtract(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1364,7 +1429,7 @@ Expr vc_bvBoolExtract(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvBoolExtract_Zero(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1380,7 +1445,7 @@ Expr vc_bvBoolExtract_Zero(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvBoolExtract_One(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1396,7 +1461,7 @@ Expr vc_bvBoolExtract_One(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvSignExtend(VC vc, Expr ccc, int nbits) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)ccc;
 
   //width of the expr which is being sign extended. nbits is the
@@ -1427,7 +1492,7 @@ Expr vc_bvSignExtend(VC vc, Expr ccc, int nbits) {
 
 //! Return an int from a constant bitvector expression
 int getBVInt(Expr e) {
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)e;
 
   if(BEEV::BVCONST != a->GetKind())
@@ -1441,7 +1506,7 @@ int getBVInt(Expr e) {
 
 //! Return an unsigned int from a constant bitvector expression
 unsigned int getBVUnsigned(Expr e) {
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)e;
 
   if(BEEV::BVCONST != a->GetKind())
@@ -1455,7 +1520,7 @@ unsigned int getBVUnsigned(Expr e) {
 
 //! Return an unsigned long long int from a constant bitvector expression
 unsigned long long int getBVUnsignedLongLong(Expr e) {
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)e;
 
   if(BEEV::BVCONST != a->GetKind())
@@ -1471,9 +1536,9 @@ unsigned long long int getBVUnsignedLongLong(Expr e) {
 
 
 Expr vc_simplify(VC vc, Expr e) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar a = (nodestar)e;
-  simpstar simp = (simpstar)(((stpstar)vc)->simp);
+  simpstar simp = (simpstar)(((vcstar)vc)->stp->simp);
 
   if(BEEV::BOOLEAN_TYPE == a->GetType()) 
     {
@@ -1594,39 +1659,38 @@ static char *val_to_binary_str(unsigned nbits, unsigned long long val) {
 #endif
 
 Expr vc_parseExpr(VC vc, const char* infile) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   extern FILE *cvcin, *smtin;
   const char * prog = "stp";
 
-  cvcin = fopen(infile,"r");
-  if(cvcin == NULL) {
+  FILE* in = fopen(infile,"r");
+  if(in == NULL) {
     fprintf(stderr,"%s: Error: cannot open %s\n",prog,infile);
     BEEV::FatalError("");
   }
 
-  //BEEV::GlobalSTP = (stpstar)vc;
-  CONSTANTBV::ErrCode c = CONSTANTBV::BitVector_Boot();
-  if(0 != c) {
-    cout << CONSTANTBV::BitVector_Error(c) << endl;
-    return 0;
-  }
+  BEEV::Cpp_interface pi(*b, b->defaultNodeFactory, ((vcstar)vc)->stp);
 
-  BEEV::Cpp_interface pi(*b, b->defaultNodeFactory);
+  pthread_mutex_lock(&parser_lock);
+  BEEV::ParserBM = b;
   BEEV::parserInterface = &pi;
 
-
   BEEV::ASTVec * AssertsQuery = new BEEV::ASTVec;
   if (b->UserFlags.smtlib1_parser_flag) 
     {
-      smtin = cvcin;
-      cvcin = NULL;
+      smtin = in;
       smtparse((void*)AssertsQuery);
     } 
   else
     {
+      cvcin = in;
       cvcparse((void*)AssertsQuery);
     }
 
+  BEEV::parserInterface = NULL;
+  BEEV::ParserBM = NULL;
+  pthread_mutex_unlock(&parser_lock);
+
   BEEV::ASTNode asserts = (*(BEEV::ASTVec*)AssertsQuery)[0];
   BEEV::ASTNode query   = (*(BEEV::ASTVec*)AssertsQuery)[1];
 
@@ -1682,7 +1746,7 @@ void vc_registerErrorHandler(void (*error_hdlr)(const char* err_msg)) {
 int vc_getHashQueryStateToBuffer(VC vc, Expr query) {
   assert(vc);
   assert(query);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   nodestar qry = (nodestar)query;
   BEEV::ASTVec v = b->GetAsserts();
   BEEV::ASTNode out = b->CreateNode(BEEV::AND,b->CreateNode(BEEV::NOT,*qry),v);
@@ -1730,32 +1794,32 @@ int vc_isBool(Expr e) {
 }
 
 void vc_Destroy(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   // for(std::vector<BEEV::ASTNode *>::iterator it=created_exprs.begin(),
   //    itend=created_exprs.end();it!=itend;it++) {
   //     BEEV::ASTNode * aaa = *it;
   //     delete aaa;
   //   }
 
-  if (cinterface_exprdelete_on_flag) {
-    for (vector<nodestar>::iterator it = persist.begin(); it!= persist.end();it++)
+  vcstar v = (vcstar)vc;
+  if (v->exprdelete_on_flag) {
+    for (vector<nodestar>::iterator it = v->persist.begin(); it!= v->persist.end();it++)
       delete *it;
-    persist.clear();
+    v->persist.clear();
   }
 
   Cnf_ClearMemory();
 
-  delete decls;
-  delete (stpstar)vc;
-  BEEV::GlobalSTP = NULL;
-  delete  BEEV::ParserBM;
-  BEEV::ParserBM = NULL;
-  delete simpNF;
+  v->decls.clear();
+  delete v->stp;
+  delete b;
+  delete v->simpNF;
+  delete v;
 }
 
 void vc_DeleteExpr(Expr e) {
   nodestar input = (nodestar)e;
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
   delete input;
 }
 
@@ -1798,8 +1862,8 @@ int getIWidth (Expr ex) {
 
 void vc_printCounterExampleFile(VC vc, int fd) {
   fdostream os(fd);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
-  ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
+  ctrexamplestar ce = (ctrexamplestar)(((vcstar)vc)->stp->Ctr_Example);  
   
   bool currentPrint = b->UserFlags.print_counterexample_flag;
   b->UserFlags.print_counterexample_flag = true;
@@ -1840,18 +1904,12 @@ extern void smt_switch_to_buffer (YY_BUFFER_STATE new_buffer  );
 int smt_scan_string(const char *yy_str);
 
 int vc_parseMemExpr(VC vc, const char* s, Expr* oquery, Expr* oasserts ) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = (bmstar)(((vcstar)vc)->stp->bm);
 
-#if 0
- BEEV::GlobalSTP = (stpstar)vc;
-  CONSTANTBV::ErrCode c = CONSTANTBV::BitVector_Boot();
-  if(0 != c) {
-    cout << CONSTANTBV::BitVector_Error(c) << endl;
-    return 0;
-  }
-#endif
-  
-  BEEV::Cpp_interface pi(*b, b->defaultNodeFactory);
+  BEEV::Cpp_interface pi(*b, b->defaultNodeFactory, ((vcstar)vc)->stp);
+
+  pthread_mutex_lock(&parser_lock);
+  BEEV::ParserBM = b;
   BEEV::parserInterface = &pi;
 
   BEEV::ASTVec AssertsQuery;
@@ -1872,6 +1930,10 @@ int vc_parseMemExpr(VC vc, const char* s, Expr* oquery, Expr* oasserts ) {
       //cvc_delete_buffer(bstat);
     }
 
+  BEEV::parserInterface = NULL;
+  BEEV::ParserBM = NULL;
+  pthread_mutex_unlock(&parser_lock);
+
   if ( oquery ) {
     *(nodestar*) oquery = new node(AssertsQuery[1]);
   }
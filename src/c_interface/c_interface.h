@@ -64,7 +64,11 @@ extern "C" {
     MS,
     SMS,
     CMS2,
-    MSP
+    MSP,
+  /*! INCREMENTAL: boolean, default false. Keep one SAT solver between
+    queries. Each vc_push level is guarded by an activation literal, so
+    vc_pop just stops assuming it and learnt clauses are kept. */
+    INCREMENTAL
 
   };
   void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value);
@@ -74,6 +78,9 @@ extern "C" {
   void make_division_total(VC vc);
 
   //! Flags can be NULL
+  // VCs share no state, so different threads can use different VCs at
+  // the same time. A single VC must only be used by one thread at a time.
+  // Parsing (vc_parseExpr, vc_parseMemExpr) is serialised between VCs.
   VC vc_createValidityChecker(void);
 
   // Basic types
@@ -219,8 +226,8 @@ extern "C" {
   // NB. The timeout is a soft timeout, use the -g flag for a hard timeout that
   // will abort automatically. The soft timeout is checked sometimes in the code,
   // and if the time has passed, then "timeout" will be returned. It's only checked
-  // sometimes though, so the actual timeout may be larger. Cryptominisat doesn't check
-  // the timeout yet..
+  // sometimes though, so the actual timeout may be larger. The timeout is measured
+  // in wall-clock time, separately for each VC.
 
   // The C-language doesn't allow default arguments, so to get it compiling, I've split
   // it into two functions.
@@ -14,6 +14,7 @@ namespace BEEV
 
     checkInvariant();
     assert(assertionsSMT2.size() == cache.size());
+    assert(stp != NULL);
 
     Entry& last_run = cache.back();
     if ((last_run.node_number != assertionsSMT2.back().GetNodeNum()) && (last_run.result == SOLVER_SATISFIABLE))
@@ -38,7 +39,7 @@ namespace BEEV
           else
             query = bm.ASTTrue;
 
-          SOLVER_RETURN_TYPE last_result = GlobalSTP->TopLevelSTP(query, bm.ASTFalse);
+          SOLVER_RETURN_TYPE last_result = stp->TopLevelSTP(query, bm.ASTFalse);
 
           // Store away the answer. Might be timeout, or error though..
           last_run = Entry(last_result);
@@ -60,7 +61,7 @@ namespace BEEV
         bm.GetRunTimes()->print();
       }
 
-    (GlobalSTP->tosat)->PrintOutput(last_run.result);
+    (stp->tosat)->PrintOutput(last_run.result);
     bm.GetRunTimes()->start(RunTimes::Parsing);
   }
 
@@ -79,7 +80,8 @@ namespace BEEV
 
     BEEV::ParserBM = &bm_;
 
-    GlobalSTP = new STP(&bm, simp, at, tosat, abs);
+    stp = new STP(&bm, simp, at, tosat, abs);
+    GlobalSTP = stp;
     init();
   }
 }
@@ -85,11 +85,14 @@ namespace BEEV
     LETMgr letMgr;
     NodeFactory* nf;
 
+    // Solves the check-sat commands. Might be NULL if there are none.
+    STP* stp;
+
     Cpp_interface(STPMgr &bm_);
 
 
-    Cpp_interface(STPMgr &bm_, NodeFactory* factory) :
-        bm(bm_), nf(factory), letMgr(bm.ASTUndefined)
+    Cpp_interface(STPMgr &bm_, NodeFactory* factory, STP* stp_ = NULL) :
+        bm(bm_), nf(factory), letMgr(bm.ASTUndefined), stp(stp_)
     {
       init();
     }
@@ -341,7 +344,8 @@ namespace BEEV
     resetSolver()
     {
       bm.ClearAllTables();
-      GlobalSTP->ClearAllTables();
+      if (stp != NULL)
+        stp->ClearAllTables();
     }
 
     // We can't pop off the zeroeth level.
@@ -415,7 +419,8 @@ namespace BEEV
     void
     deleteGlobal()
     {
-      delete GlobalSTP;
+      delete stp;
+      stp = NULL;
     }
 
     void
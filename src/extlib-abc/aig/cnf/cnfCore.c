@@ -24,7 +24,9 @@
 ///                        DECLARATIONS                              ///
 ////////////////////////////////////////////////////////////////////////
 
-static Cnf_Man_t * s_pManCnf = NULL;
+// Each thread has its own manager, so VCs on different threads can
+// generate CNF at the same time.
+static __thread Cnf_Man_t * s_pManCnf = NULL;
 
 ////////////////////////////////////////////////////////////////////////
 ///                     FUNCTION DEFINITIONS                         ///
@@ -32,19 +34,19 @@ static Cnf_Man_t * s_pManCnf = NULL;
 
 /**Function*************************************************************
 
-  Synopsis    [Converts AIG into the SAT solver.]
+  Synopsis    [Maps the AIG for CNF.]
 
-  Description []
+  Description [Returns the mapped nodes in topological order. The cuts
+  that were enumerated are freed once the best ones have been copied.]
                
   SideEffects []
 
   SeeAlso     []
 
 ***********************************************************************/
-Cnf_Dat_t * Cnf_Derive( Aig_Man_t * pAig, int nOutputs )
+static Vec_Ptr_t * Cnf_DeriveMapping_( Aig_Man_t * pAig )
 {
     Cnf_Man_t * p;
-    Cnf_Dat_t * pCnf;
     Vec_Ptr_t * vMapped;
     Aig_MmFixed_t * pMemCuts;
     int clk;
@@ -54,6 +56,8 @@ Cnf_Dat_t * Cnf_Derive( Aig_Man_t * pAig, int nOutputs )
     // connect the managers
     p = s_pManCnf;
     p->pManAig = pAig;
+    // the cuts of the last AIG aren't needed, and would pile up otherwise
+    Aig_MmFlexRestart( p->pMemCuts );
 
     // generate cuts for all nodes, assign cost, and find best cuts
 clk = clock();
@@ -66,14 +70,36 @@ clk = clock();
 p->timeMap = clock() - clk;
 //    Aig_ManScanMapping( p, 1 );
 
-    // convert it into CNF
-clk = clock();
     Cnf_ManTransferCuts( p );
+    Aig_MmFixedStop( pMemCuts, 0 );
     vMapped = Cnf_ManScanMapping( p, 1, 1 );
-    pCnf = Cnf_ManWriteCnf( p, vMapped, nOutputs );
+    return vMapped;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Converts AIG into the SAT solver.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+Cnf_Dat_t * Cnf_Derive( Aig_Man_t * pAig, int nOutputs )
+{
+    Cnf_Dat_t * pCnf;
+    Vec_Ptr_t * vMapped;
+    int clk;
+
+    vMapped = Cnf_DeriveMapping_( pAig );
+
+    // convert it into CNF
+clk = clock();
+    pCnf = Cnf_ManWriteCnf( s_pManCnf, vMapped, nOutputs );
     Vec_PtrFree( vMapped );
-    Aig_MmFixedStop( pMemCuts, 0 );
-p->timeSave = clock() - clk;
+s_pManCnf->timeSave = clock() - clk;
 
    // reset reference counters
     Aig_ManResetRefs( pAig );
@@ -83,6 +109,32 @@ p->timeSave = clock() - clk;
     return pCnf;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Maps the AIG for CNF, without writing the clauses.]
+
+  Description [See Cnf_ManPrepareCnf(). The clauses are written by
+  Cnf_DataStream(), which must be called before the CNF manager is
+  used again or cleared.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+Cnf_Dat_t * Cnf_DeriveForStream( Aig_Man_t * pAig )
+{
+    Cnf_Dat_t * pCnf;
+    Vec_Ptr_t * vMapped;
+
+    vMapped = Cnf_DeriveMapping_( pAig );
+    pCnf = Cnf_ManPrepareCnf( s_pManCnf, vMapped );
+    Vec_PtrFree( vMapped );
+
+    Aig_ManResetRefs( pAig );
+    return pCnf;
+}
+
 /**Function*************************************************************
 
   Synopsis    []
@@ -101,9 +153,9 @@ Cnf_Man_t * Cnf_ManRead()
 
 /**Function*************************************************************
 
-  Synopsis    []
+  Synopsis    [Frees the calling thread's manager.]
 
-  Description []
+  Description [The SOP tables are shared by the process, so they're kept.]
                
   SideEffects []
 
@@ -19,6 +19,7 @@
 ***********************************************************************/
 
 #include "cnf.h"
+#include <pthread.h>
 //#include "satSolver.h"
 
 ////////////////////////////////////////////////////////////////////////
@@ -28,6 +29,13 @@
 static inline int Cnf_Lit2Var( int Lit )        { return (Lit & 1)? -(Lit >> 1)-1 : (Lit >> 1)+1;  }
 static inline int Cnf_Lit2Var2( int Lit )       { return (Lit & 1)? -(Lit >> 1)   : (Lit >> 1);    }
 
+// The SOP tables are read once per process and shared by all managers.
+static char *  s_pSopSizes = NULL;
+static char ** s_pSops = NULL;
+static pthread_once_t s_SopsOnce = PTHREAD_ONCE_INIT;
+
+static void Cnf_ReadSharedMsops() { Cnf_ReadMsops( &s_pSopSizes, &s_pSops ); }
+
 ////////////////////////////////////////////////////////////////////////
 ///                     FUNCTION DEFINITIONS                         ///
 ////////////////////////////////////////////////////////////////////////
@@ -51,7 +59,9 @@ Cnf_Man_t * Cnf_ManStart()
     p = ALLOC( Cnf_Man_t, 1 );
     memset( p, 0, sizeof(Cnf_Man_t) );
     // derive internal data structures
-    Cnf_ReadMsops( &p->pSopSizes, &p->pSops );
+    pthread_once( &s_SopsOnce, Cnf_ReadSharedMsops );
+    p->pSopSizes = s_pSopSizes;
+    p->pSops = s_pSops;
     // allocate memory manager for cuts
     p->pMemCuts = Aig_MmFlexStart();
     p->nMergeLimit = 10;
@@ -79,9 +89,6 @@ void Cnf_ManStop( Cnf_Man_t * p )
     Vec_IntFree( p->vMemory );
     free( p->pTruths[0] );
     Aig_MmFlexStop( p->pMemCuts, 0 );
-    free( p->pSopSizes );
-    free( p->pSops[1] );
-    free( p->pSops );
     free( p );
 }
 
@@ -122,9 +129,16 @@ void Cnf_DataFree( Cnf_Dat_t * p )
 {
     if ( p == NULL )
         return;
-    free( p->pClauses[0] );
-    free( p->pClauses );
+    if ( p->pClauses )
+    {
+        free( p->pClauses[0] );
+        free( p->pClauses );
+    }
     free( p->pVarNums );
+    if ( p->vCuts )
+        Vec_PtrFree( p->vCuts );
+    if ( p->vUnits )
+        Vec_IntFree( p->vUnits );
     free( p );
 }
 
@@ -318,6 +318,145 @@ Cnf_Dat_t * Cnf_ManWriteCnf( Cnf_Man_t * p, Vec_Ptr_t * vMapped, int nOutputs )
     return pCnf;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Prepares the CNF for the mapping, without writing it.]
+
+  Description [Like Cnf_ManWriteCnf() without extra outputs, but only
+  the variables are numbered. The best cuts of the mapped nodes and the
+  unit clauses are kept in the CNF, so that Cnf_DataStream() can write
+  the clauses after the AIG has gone.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+Cnf_Dat_t * Cnf_ManPrepareCnf( Cnf_Man_t * p, Vec_Ptr_t * vMapped )
+{
+    Aig_Obj_t * pObj;
+    Cnf_Dat_t * pCnf;
+    int i, Number;
+
+    pCnf = ALLOC( Cnf_Dat_t, 1 );
+    memset( pCnf, 0, sizeof(Cnf_Dat_t) );
+
+    // assign variables to the internal nodes, the PIs and the constant node
+    pCnf->pVarNums = ALLOC( int, Aig_ManObjNumMax(p->pManAig) );
+    memset( pCnf->pVarNums, 0xff, sizeof(int) * Aig_ManObjNumMax(p->pManAig) );
+    Number = 1;
+    Vec_PtrForEachEntry( vMapped, pObj, i )
+        pCnf->pVarNums[pObj->Id] = Number++;
+    Aig_ManForEachPi( p->pManAig, pObj, i )
+        pCnf->pVarNums[pObj->Id] = Number++;
+    pCnf->pVarNums[Aig_ManConst1(p->pManAig)->Id] = Number++;
+    pCnf->nVars = Number;
+
+    // the node with variable i+1 has the i-th cut
+    pCnf->vCuts = Vec_PtrAlloc( Vec_PtrSize(vMapped) );
+    Vec_PtrForEachEntry( vMapped, pObj, i )
+        Vec_PtrPush( pCnf->vCuts, Cnf_ObjBestCut(pObj) );
+
+    // the constant literal and the output literals
+    pCnf->vUnits = Vec_IntAlloc( 1 + Aig_ManPoNum(p->pManAig) );
+    Vec_IntPush( pCnf->vUnits, 2 * pCnf->pVarNums[ Aig_ManConst1(p->pManAig)->Id ] );
+    Aig_ManForEachPo( p->pManAig, pObj, i )
+        Vec_IntPush( pCnf->vUnits, 2 * pCnf->pVarNums[ Aig_ObjFanin0(pObj)->Id ] + Aig_ObjFaninC0(pObj) );
+    return pCnf;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes the clauses of a prepared CNF into the sink.]
+
+  Description [Each clause is passed to the sink as soon as it is
+  written, so the clauses are never held together. The clause buffer
+  is reused, the sink must copy what it keeps. Stops early if the sink
+  returns 0, and then returns 0. Needs the cuts from the CNF manager,
+  but not the AIG.]
+               
+  SideEffects [Frees the cuts kept in the CNF.]
+
+  SeeAlso     []
+
+***********************************************************************/
+int Cnf_DataStream( Cnf_Dat_t * pCnf, Cnf_ClauseSink_t pSink, void * pData )
+{
+    Cnf_Man_t * p = Cnf_ManRead();
+    Cnf_Cut_t * pCut;
+    Vec_Int_t * vCover, * vSopTemp;
+    int OutVar, pVars[32], pLits[33];
+    unsigned uTruth;
+    int i, k, nLits, Cube, fOkay = 1;
+
+    assert( p != NULL && pCnf->vCuts != NULL );
+    vSopTemp = Vec_IntAlloc( 1 << 16 );
+    Vec_PtrForEachEntry( pCnf->vCuts, pCut, i )
+    {
+        assert( pCut->nFanins <= 32 );
+        OutVar = i + 1;
+        for ( k = 0; k < (int)pCut->nFanins; k++ )
+            pVars[k] = pCnf->pVarNums[ pCut->pFanins[k] ];
+
+        // positive polarity of the cut
+        if ( pCut->nFanins < 5 )
+        {
+            uTruth = 0xFFFF & *Cnf_CutTruth(pCut);
+            Cnf_SopConvertToVector( p->pSops[uTruth], p->pSopSizes[uTruth], vSopTemp );
+            vCover = vSopTemp;
+        }
+        else
+            vCover = pCut->vIsop[1];
+        Vec_IntForEachEntry( vCover, Cube, k )
+        {
+            pLits[0] = 2 * OutVar;
+            nLits = 1 + Cnf_IsopWriteCube( Cube, pCut->nFanins, pVars, pLits + 1 );
+            pCnf->nLiterals += nLits;
+            pCnf->nClauses++;
+            if ( fOkay && !pSink( pData, pLits, nLits ) )
+                fOkay = 0;
+        }
+
+        // negative polarity of the cut
+        if ( pCut->nFanins < 5 )
+        {
+            uTruth = 0xFFFF & ~*Cnf_CutTruth(pCut);
+            Cnf_SopConvertToVector( p->pSops[uTruth], p->pSopSizes[uTruth], vSopTemp );
+            vCover = vSopTemp;
+        }
+        else
+            vCover = pCut->vIsop[0];
+        Vec_IntForEachEntry( vCover, Cube, k )
+        {
+            pLits[0] = 2 * OutVar + 1;
+            nLits = 1 + Cnf_IsopWriteCube( Cube, pCut->nFanins, pVars, pLits + 1 );
+            pCnf->nLiterals += nLits;
+            pCnf->nClauses++;
+            if ( fOkay && !pSink( pData, pLits, nLits ) )
+                fOkay = 0;
+        }
+        if ( !fOkay )
+            break;
+    }
+    Vec_IntFree( vSopTemp );
+
+    // write the constant literal and the output literals
+    Vec_IntForEachEntry( pCnf->vUnits, pLits[0], k )
+    {
+        if ( !fOkay )
+            break;
+        pCnf->nLiterals++;
+        pCnf->nClauses++;
+        fOkay = pSink( pData, pLits, 1 );
+    }
+
+    Vec_PtrFree( pCnf->vCuts );
+    Vec_IntFree( pCnf->vUnits );
+    pCnf->vCuts = NULL;
+    pCnf->vUnits = NULL;
+    return fOkay;
+}
+
 // Create a new partial CNF with just the extra bits versus the old CNF.
 // This uses the Tseitin transform of Cnf_DeriveSimple
 // NB. We assume there will only be one more PO than last time.
@@ -19,6 +19,7 @@
 ***********************************************************************/
 
 #include "darInt.h"
+#include <pthread.h>
 
 ////////////////////////////////////////////////////////////////////////
 ///                        DECLARATIONS                              ///
@@ -97,7 +98,12 @@ struct Dar_Lib_t_ // library
     unsigned char *  pMap;
 };
 
-static Dar_Lib_t * s_DarLib = NULL;
+// The library is read once per process and shared. Rewriting writes into
+// the objects and the prepared classes, so each thread works on a copy of
+// those, and shares the rest.
+static Dar_Lib_t * s_DarLibShared = NULL;
+static pthread_once_t s_DarLibOnce = PTHREAD_ONCE_INIT;
+static __thread Dar_Lib_t * s_DarLib = NULL;
 
 static inline Dar_LibObj_t * Dar_LibObj( Dar_Lib_t * p, int Id )    { return p->pObjs + Id; }
 static inline int            Dar_LibObjTruth( Dar_LibObj_t * pObj ) { return pObj->Num < (0xFFFF & ~pObj->Num) ? pObj->Num : (0xFFFF & ~pObj->Num); }
@@ -565,15 +571,88 @@ Dar_Lib_t * Dar_LibRead()
   SeeAlso     []
 
 ***********************************************************************/
-void Dar_LibStart()
+static void Dar_LibReadShared()
 {
 //    int clk = clock();
-    assert( s_DarLib == NULL );
-    s_DarLib = Dar_LibRead();
-//    printf( "The 4-input library started with %d nodes and %d subgraphs. ", s_DarLib->nObjs - 4, s_DarLib->nSubgrTotal );
+    s_DarLibShared = Dar_LibRead();
+//    printf( "The 4-input library started with %d nodes and %d subgraphs. ", s_DarLibShared->nObjs - 4, s_DarLibShared->nSubgrTotal );
 //    PRT( "Time", clock() - clk );
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Copies the parts of the library that rewriting writes.]
+
+  Description [The classes, priorities, nodes and NPN tables are shared
+  with the original, which must outlive the copy.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+Dar_Lib_t * Dar_LibCopy( Dar_Lib_t * pLib )
+{
+    Dar_Lib_t * p;
+    int i;
+    p = ALLOC( Dar_Lib_t, 1 );
+    memcpy( p, pLib, sizeof(Dar_Lib_t) );
+    p->pObjs = ALLOC( Dar_LibObj_t, p->nObjs );
+    memcpy( p->pObjs, pLib->pObjs, sizeof(Dar_LibObj_t) * p->nObjs );
+    // the prepared library is rebuilt by Dar_LibPrepare()
+    p->pNodes0Mem = ALLOC( int, p->nNodesTotal );
+    p->pSubgr0Mem = ALLOC( int, p->nSubgrTotal );
+    for ( i = 0; i < 222; i++ )
+    {
+        p->pNodes0[i] = p->pNodes0Mem + (pLib->pNodes0[i] - pLib->pNodes0Mem);
+        p->pSubgr0[i] = p->pSubgr0Mem + (pLib->pSubgr0[i] - pLib->pSubgr0Mem);
+    }
+    p->nSubgraphs = 0;
+    p->pDatas = NULL;
+    p->nDatas = 0;
+    return p;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Frees a copy made by Dar_LibCopy().]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void Dar_LibFreeCopy( Dar_Lib_t * p )
+{
+    free( p->pObjs );
+    FREE( p->pDatas );
+    free( p->pNodes0Mem );
+    free( p->pSubgr0Mem );
+    free( p );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Starts the library.]
+
+  Description [Reads the shared library the first time it's called in
+  the process. Gives the calling thread its own copy to rewrite with,
+  unless it already has one.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void Dar_LibStart()
+{
+    pthread_once( &s_DarLibOnce, Dar_LibReadShared );
+    if ( s_DarLib == NULL )
+        s_DarLib = Dar_LibCopy( s_DarLibShared );
+}
+
 /**Function*************************************************************
 
   Synopsis    [Stops the library.]
@@ -587,8 +666,9 @@ void Dar_LibStart()
 ***********************************************************************/
 void Dar_LibStop()
 {
-    assert( s_DarLib != NULL );
-    Dar_LibFree( s_DarLib );
+    if ( s_DarLib == NULL )
+        return;
+    Dar_LibFreeCopy( s_DarLib );
     s_DarLib = NULL;
 }
 
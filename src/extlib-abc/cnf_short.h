@@ -51,6 +51,9 @@ typedef struct Cnf_Man_t_            Cnf_Man_t;
 typedef struct Cnf_Dat_t_            Cnf_Dat_t;
 typedef struct Cnf_Cut_t_            Cnf_Cut_t;
 
+// receives the CNF one clause at a time; returns 0 to stop
+typedef int (*Cnf_ClauseSink_t)( void * pData, int * pLits, int nLits );
+
 // the CNF asserting outputs of AIG to be 1
 struct Cnf_Dat_t_
 {
@@ -60,6 +63,8 @@ struct Cnf_Dat_t_
     int             nClauses;        // the number of CNF clauses
     int **          pClauses;        // the CNF clauses
     int *           pVarNums;        // the number of CNF variable for each node ID (-1 if unused)
+    Vec_Ptr_t *     vCuts;           // the cuts of the mapped nodes, until they're streamed
+    Vec_Int_t *     vUnits;          // the unit clauses, until they're streamed
 };
 
 // the cut used to represent node in the AIG
@@ -118,6 +123,7 @@ static inline void         Cnf_ObjSetBestCut( Aig_Obj_t * pObj, Cnf_Cut_t * pCut
 
 /*=== cnfCore.c ========================================================*/
 extern Cnf_Dat_t *     Cnf_Derive( Aig_Man_t * pAig, int nOutputs );
+extern Cnf_Dat_t *     Cnf_DeriveForStream( Aig_Man_t * pAig );
 extern Cnf_Man_t *     Cnf_ManRead();
 extern void            Cnf_ClearMemory();
 /*=== cnfCut.c ========================================================*/
@@ -148,6 +154,8 @@ extern Vec_Ptr_t *     Cnf_ManScanMapping( Cnf_Man_t * p, int fCollect, int fPre
 /*=== cnfWrite.c ========================================================*/
 extern void            Cnf_SopConvertToVector( char * pSop, int nCubes, Vec_Int_t * vCover );
 extern Cnf_Dat_t *     Cnf_ManWriteCnf( Cnf_Man_t * p, Vec_Ptr_t * vMapped, int nOutputs );
+extern Cnf_Dat_t *     Cnf_ManPrepareCnf( Cnf_Man_t * p, Vec_Ptr_t * vMapped );
+extern int             Cnf_DataStream( Cnf_Dat_t * pCnf, Cnf_ClauseSink_t pSink, void * pData );
 extern Cnf_Dat_t *     Cnf_DeriveSimple( Aig_Man_t * p, int nOutputs );
 // NB: This is an STP function...
 extern Cnf_Dat_t * Cnf_DeriveSimple_Additional( Aig_Man_t * p, Cnf_Dat_t * old );
@@ -63,7 +63,7 @@ static const intptr_t INITIAL_MEMORY_PREALLOCATION_SIZE = 4000000;
  * step 5. Call SAT to determine if input is SAT or UNSAT
  ********************************************************************/
 
-typedef enum {PRINT_BACK_C=1, PRINT_BACK_CVC, PRINT_BACK_SMTLIB2,PRINT_BACK_SMTLIB1, PRINT_BACK_GDL, PRINT_BACK_DOT, OUTPUT_BENCH, OUTPUT_CNF, USE_SIMPLIFYING_SOLVER, SMT_LIB2_FORMAT, SMT_LIB1_FORMAT, DISABLE_CBITP,EXIT_AFTER_CNF,USE_CRYPTOMINISAT_SOLVER,USE_MINISAT_SOLVER, DISABLE_SIMPLIFICATIONS, OLDSTYLE_REFINEMENT, DISABLE_EQUALITY, RANDOM_SEED,HASHING_NF} OptionType;
+typedef enum {PRINT_BACK_C=1, PRINT_BACK_CVC, PRINT_BACK_SMTLIB2,PRINT_BACK_SMTLIB1, PRINT_BACK_GDL, PRINT_BACK_DOT, OUTPUT_BENCH, OUTPUT_CNF, USE_SIMPLIFYING_SOLVER, SMT_LIB2_FORMAT, SMT_LIB1_FORMAT, DISABLE_CBITP,EXIT_AFTER_CNF,USE_CRYPTOMINISAT_SOLVER,USE_MINISAT_SOLVER, DISABLE_SIMPLIFICATIONS, OLDSTYLE_REFINEMENT, DISABLE_EQUALITY, RANDOM_SEED,HASHING_NF,INCREMENTAL,PORTFOLIO} OptionType;
 
 
 int main(int argc, char ** argv) {
@@ -119,6 +119,8 @@ int main(int argc, char ** argv) {
     "--cryptominisat        : use cryptominisat2 as the solver\n"
     "--simplifying-minisat  : use simplifying-minisat 2.2 as the solver\n"
     "--minisat              : use minisat 2.2 as the solver\n"
+    "--incremental          : keep the SAT solver between queries\n"
+    "--portfolio <n>        : race n SAT solvers in separate threads\n"
     "\n"
     "--oldstyle-refinement  : Do abstraction-refinement outside the SAT solver\n"
     "-r                     : Eagerly encode array-read axioms (Ackermannistaion)\n"
@@ -180,6 +182,8 @@ int main(int argc, char ** argv) {
 			  lookup.insert(make_pair(tolower("--disable-equality"),DISABLE_EQUALITY));
 			  lookup.insert(make_pair(tolower("--random-seed"),RANDOM_SEED));
 			  lookup.insert(make_pair(tolower("--hash-nf"),HASHING_NF));
+			  lookup.insert(make_pair(tolower("--incremental"),INCREMENTAL));
+			  lookup.insert(make_pair(tolower("--portfolio"),PORTFOLIO));
 
 
 			  if (!strncmp(argv[i],"--config_",strlen("--config_")))
@@ -284,6 +288,14 @@ int main(int argc, char ** argv) {
                           case HASHING_NF:
                               bm->defaultNodeFactory = bm->hashingNodeFactory;
                               break;
+                          case INCREMENTAL:
+                              bm->UserFlags.incremental_flag = true;
+                              break;
+                          case PORTFOLIO:
+                              if (i + 1 >= argc || atoi(argv[i+1]) < 1)
+                                FatalError("--portfolio needs the number of solvers to race");
+                              bm->UserFlags.portfolio_size = atoi(argv[++i]);
+                              break;
 
 			  default:
 				  fprintf(stderr,usage,prog);
@@ -402,8 +414,8 @@ int main(int argc, char ** argv) {
                 TypeChecker nfTypeCheckSimp(*bm->defaultNodeFactory, *bm);
 		TypeChecker nfTypeCheckDefault(*bm->hashingNodeFactory, *bm);
 
-		Cpp_interface piTypeCheckSimp(*bm, &nfTypeCheckSimp);
-		Cpp_interface piTypeCheckDefault(*bm, &nfTypeCheckDefault);
+		Cpp_interface piTypeCheckSimp(*bm, &nfTypeCheckSimp, GlobalSTP);
+		Cpp_interface piTypeCheckDefault(*bm, &nfTypeCheckDefault, GlobalSTP);
 
 		// If you are converting formats, you probably don't want it simplifying (at least I dont).
 		if (onePrintBack)
@@ -189,7 +189,7 @@ cmd             :      other_cmd
 counterexample  :      COUNTEREXAMPLE_TOK ';'
 {
   parserInterface->getUserFlags().print_counterexample_flag = true;
-  (GlobalSTP->Ctr_Example)->PrintCounterExample(true);
+  (parserInterface->stp->Ctr_Example)->PrintCounterExample(true);
 }                              
 ;
 
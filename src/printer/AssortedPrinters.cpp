@@ -134,12 +134,13 @@ namespace BEEV
 	  ASTNodeSet visited;
 	  ASTNodeSet symbols;
 	  buildListOfSymbols(query,  visited, symbols);
-      ASTVec v = (BEEV::GlobalSTP->bm)->GetAsserts();
+	  STPMgr* bm = query.GetSTPMgr();
+      ASTVec v = bm->GetAsserts();
       for(ASTVec::iterator i=v.begin(),iend=v.end();i!=iend;i++)
     	buildListOfSymbols(*i,  visited, symbols);
 
-	(BEEV::GlobalSTP->bm)->printVarDeclsToStream(cout, symbols);
-    (BEEV::GlobalSTP->bm)->printAssertsToStream(cout,0);
+	bm->printVarDeclsToStream(cout, symbols);
+    bm->printAssertsToStream(cout,0);
     cout << "QUERY(";
     query.PL_Print(cout);
     cout << ");\n";
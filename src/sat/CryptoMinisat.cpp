@@ -13,28 +13,53 @@
 namespace BEEV
 {
 
-  CryptoMinisat::CryptoMinisat()
+  CryptoMinisat::CryptoMinisat(volatile bool& interrupt) :
+    asynch_interrupt(interrupt)
   {
      s = new MINISAT::Solver();
+     s->setInterrupt(&asynch_interrupt);
+     buffer = new MINISAT::vec<MINISAT::Lit>();
   }
 
   CryptoMinisat::~CryptoMinisat()
   {
+    delete buffer;
     delete s;
   }
 
   bool
   CryptoMinisat::addClause(const vec_literals& ps) // Add a clause to the solver.
   {
-    // Cryptominisat uses a slightly different vec class.
-    // Cryptominisat uses a slightly different Lit class too.
+    return addClause(ps.size() == 0 ? NULL : &ps[0], ps.size());
+  }
 
-    // VERY SLOW>
-    MINISAT::vec<MINISAT::Lit>  v;
-    for (int i =0; i<ps.size();i++)
-      v.push(MINISAT::Lit(var(ps[i]), sign(ps[i])));
+  bool
+  CryptoMinisat::addClause(const Minisat::Lit* lits, int size)
+  {
+    // Cryptominisat uses a slightly different vec class, and its own Lit
+    // class, but the literals have the same layout. The solver may shrink
+    // the vector, so it's filled again each time.
+    buffer->clear();
+    buffer->capacity(size);
+    for (int i = 0; i < size; i++)
+      buffer->push(MINISAT::Lit::toLit(lits[i].x));
+    return s->addClause(*buffer);
+  }
 
-    s->addClause(v);
+  bool
+  CryptoMinisat::addXorClause(const vec_literals& ps)
+  {
+    // The solver wants the variables, with the signs folded into whether
+    // the clause is inverted, i.e. whether an even number must be true.
+    bool inverted = false;
+    buffer->clear();
+    buffer->capacity(ps.size());
+    for (int i = 0; i < ps.size(); i++)
+      {
+        buffer->push(MINISAT::Lit(var(ps[i]), false));
+        inverted ^= sign(ps[i]);
+      }
+    return s->addXorClause(*buffer, inverted);
   }
 
   bool
@@ -46,7 +71,54 @@ namespace BEEV
   bool
   CryptoMinisat::solve() // Search without assumptions.
   {
-    return s->solve().getchar();
+    s->budgetOff();
+    return s->solve() == MINISAT::l_True;
+  }
+
+  bool
+  CryptoMinisat::solve(const vec_literals& assumps) // Search under assumptions.
+  {
+    MINISAT::vec<MINISAT::Lit>  v;
+    for (int i =0; i<assumps.size();i++)
+      v.push(MINISAT::Lit(var(assumps[i]), sign(assumps[i])));
+
+    s->budgetOff();
+    return s->solve(v) == MINISAT::l_True;
+  }
+
+  SATSolver::lbool
+  CryptoMinisat::solveLimited(const vec_literals& assumps) // Search under assumptions, within the budgets.
+  {
+    MINISAT::vec<MINISAT::Lit>  v;
+    for (int i =0; i<assumps.size();i++)
+      v.push(MINISAT::Lit(var(assumps[i]), sign(assumps[i])));
+
+    return s->solve(v).getchar();
+  }
+
+  void CryptoMinisat::setConflictBudget(int64_t x)
+  {
+    s->setConfBudget(x);
+  }
+
+  void CryptoMinisat::setPropagationBudget(int64_t x)
+  {
+    s->setPropBudget(x);
+  }
+
+  void CryptoMinisat::budgetOff()
+  {
+    s->budgetOff();
+  }
+
+  void CryptoMinisat::interrupt()
+  {
+    asynch_interrupt = true;
+  }
+
+  void CryptoMinisat::clearInterrupt()
+  {
+    asynch_interrupt = false;
   }
 
   uint8_t
@@ -64,6 +136,12 @@ namespace BEEV
   int CryptoMinisat::setVerbosity(int v)
   {
     s->verbosity = v;
+    return v;
+  }
+
+  void CryptoMinisat::setSeed(int i)
+  {
+    s->setSeed(i);
   }
 
   int CryptoMinisat::nVars()
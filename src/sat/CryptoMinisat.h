@@ -9,6 +9,8 @@
 namespace MINISAT
 {
    class Solver;
+   class Lit;
+   template<class T> class vec;
 }
 
 namespace BEEV
@@ -16,15 +18,29 @@ namespace BEEV
   class CryptoMinisat : public SATSolver
   {
     MINISAT::Solver* s;
+    MINISAT::vec<MINISAT::Lit>* buffer; // Reused when adding clauses.
+    volatile bool& asynch_interrupt;
 
   public:
-    CryptoMinisat();
+    CryptoMinisat(volatile bool& interrupt);
 
     ~CryptoMinisat();
 
     bool
     addClause(const vec_literals& ps); // Add a clause to the solver.
 
+    bool
+    addClause(const Minisat::Lit* lits, int size);
+
+    bool
+    acceptsXorClauses()
+    {
+      return true;
+    }
+
+    bool
+    addXorClause(const vec_literals& ps);
+
     bool
     okay() const; // FALSE means solver is in a conflicting state
 
@@ -32,6 +48,19 @@ namespace BEEV
     bool
     solve(); // Search without assumptions.
 
+    bool
+    solve(const vec_literals& assumps); // Search under assumptions.
+
+    lbool
+    solveLimited(const vec_literals& assumps); // Search under assumptions, within the budgets.
+
+    void setConflictBudget(int64_t x);
+    void setPropagationBudget(int64_t x);
+    void budgetOff();
+
+    void interrupt();
+    void clearInterrupt();
+
     virtual uint8_t modelValue(Var x) const;
 
     virtual Var newVar();
@@ -42,6 +71,8 @@ namespace BEEV
 
     void printStats();
 
+    virtual void setSeed(int i);
+
     //nb CMS2 has different literal values to the other minisats.
     virtual lbool true_literal() {return ((uint8_t)1);}
     virtual lbool false_literal()  {return ((uint8_t)-1);}
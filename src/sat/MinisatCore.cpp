@@ -22,7 +22,19 @@ namespace BEEV
   bool
   MinisatCore<T>::addClause(const SATSolver::vec_literals& ps) // Add a clause to the solver.
   {
-    s->addClause(ps);
+    return s->addClause(ps);
+  }
+
+  template <class T>
+  bool
+  MinisatCore<T>::addClause(const Minisat::Lit* lits, int size)
+  {
+    // addClause(ps) would copy ps again before adding it.
+    buffer.clear();
+    buffer.capacity(size);
+    for (int i = 0; i < size; i++)
+      buffer.push_(lits[i]);
+    return s->addClause_(buffer);
   }
 
   template <class T>
@@ -43,6 +55,56 @@ namespace BEEV
 
   }
 
+  template <class T>
+  bool
+  MinisatCore<T>::solve(const vec_literals& assumps) // Search under assumptions.
+  {
+    if (!s->simplify())
+      return false;
+
+    return s->solve(assumps);
+  }
+
+  template <class T>
+  SATSolver::lbool
+  MinisatCore<T>::solveLimited(const vec_literals& assumps) // Search under assumptions, within the budgets.
+  {
+    if (!s->simplify())
+      return false_literal();
+
+    return Minisat::toInt(s->solveLimited(assumps));
+  }
+
+  template <class T>
+  void MinisatCore<T>::setConflictBudget(int64_t x)
+  {
+    s->setConfBudget(x);
+  }
+
+  template <class T>
+  void MinisatCore<T>::setPropagationBudget(int64_t x)
+  {
+    s->setPropBudget(x);
+  }
+
+  template <class T>
+  void MinisatCore<T>::budgetOff()
+  {
+    s->budgetOff();
+  }
+
+  template <class T>
+  void MinisatCore<T>::interrupt()
+  {
+    s->interrupt();
+  }
+
+  template <class T>
+  void MinisatCore<T>::clearInterrupt()
+  {
+    s->clearInterrupt();
+  }
+
   template <class T>
   uint8_t
   MinisatCore<T>::modelValue(Var x) const
@@ -61,6 +123,7 @@ namespace BEEV
   int MinisatCore<T>::setVerbosity(int v)
   {
     s->verbosity = v;
+    return v;
   }
 
     template <class T>
@@ -97,7 +160,7 @@ namespace BEEV
   template <class T>
     bool MinisatCore<T>::simplify()
   {
-    s->simplify();
+    return s->simplify();
   }
 
 
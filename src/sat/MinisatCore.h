@@ -17,6 +17,7 @@ namespace BEEV
   class MinisatCore: public SATSolver
   {
     T * s;
+    vec_literals buffer; // Reused by addClause(lits, size).
 
   public:
     MinisatCore(volatile bool& interrupt);
@@ -26,6 +27,9 @@ namespace BEEV
     bool
     addClause(const vec_literals& ps); // Add a clause to the solver.
 
+    bool
+    addClause(const Minisat::Lit* lits, int size);
+
     bool
     okay() const; // FALSE means solver is in a conflicting state
 
@@ -33,6 +37,19 @@ namespace BEEV
     bool
     solve(); // Search without assumptions.
 
+    bool
+    solve(const vec_literals& assumps); // Search under assumptions.
+
+    lbool
+    solveLimited(const vec_literals& assumps); // Search under assumptions, within the budgets.
+
+    void setConflictBudget(int64_t x);
+    void setPropagationBudget(int64_t x);
+    void budgetOff();
+
+    void interrupt();
+    void clearInterrupt();
+
     virtual
     bool
     simplify(); // Removes already satisfied clauses.
@@ -30,7 +30,19 @@ namespace BEEV
   bool
   MinisatCore_prop<T>::addClause(const SATSolver::vec_literals& ps) // Add a clause to the solver.
   {
-    s->addClause(ps);
+    return s->addClause(ps);
+  }
+
+  template <class T>
+  bool
+  MinisatCore_prop<T>::addClause(const Minisat::Lit* lits, int size)
+  {
+    // addClause(ps) would copy ps again before adding it.
+    buffer.clear();
+    buffer.capacity(size);
+    for (int i = 0; i < size; i++)
+      buffer.push_(lits[i]);
+    return s->addClause_(buffer);
   }
 
   template <class T>
@@ -51,6 +63,56 @@ namespace BEEV
 
   }
 
+  template <class T>
+  bool
+  MinisatCore_prop<T>::solve(const vec_literals& assumps) // Search under assumptions.
+  {
+    if (!s->simplify())
+      return false;
+
+    return s->solve(assumps);
+  }
+
+  template <class T>
+  SATSolver::lbool
+  MinisatCore_prop<T>::solveLimited(const vec_literals& assumps) // Search under assumptions, within the budgets.
+  {
+    if (!s->simplify())
+      return false_literal();
+
+    return Minisat::toInt(s->solveLimited(assumps));
+  }
+
+  template <class T>
+  void MinisatCore_prop<T>::setConflictBudget(int64_t x)
+  {
+    s->setConfBudget(x);
+  }
+
+  template <class T>
+  void MinisatCore_prop<T>::setPropagationBudget(int64_t x)
+  {
+    s->setPropBudget(x);
+  }
+
+  template <class T>
+  void MinisatCore_prop<T>::budgetOff()
+  {
+    s->budgetOff();
+  }
+
+  template <class T>
+  void MinisatCore_prop<T>::interrupt()
+  {
+    s->interrupt();
+  }
+
+  template <class T>
+  void MinisatCore_prop<T>::clearInterrupt()
+  {
+    s->clearInterrupt();
+  }
+
   template <class T>
   uint8_t
   MinisatCore_prop<T>::modelValue(Var x) const
@@ -69,6 +131,7 @@ namespace BEEV
   int MinisatCore_prop<T>::setVerbosity(int v)
   {
     s->verbosity = v;
+    return v;
   }
 
   template <class T>
@@ -0,0 +1,289 @@
+#include "PortfolioSolver.h"
+#include <cassert>
+#include <sys/time.h>
+#include <cstdio>
+
+namespace BEEV
+{
+  PortfolioSolver::PortfolioSolver(volatile bool& interrupt, int size) :
+    interrupt_flag(interrupt)
+  {
+    assert(size > 0);
+    for (int i = 0; i < size; i++)
+      {
+        Backend* b = new Backend;
+        b->s = NULL;
+        b->handlesArrays = false;
+        b->stop = false;
+        b->running = false;
+        b->owner = this;
+        backends.push_back(b);
+      }
+    arraysAdded = false;
+    winner = NULL;
+    assumptions = NULL;
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&finished, NULL);
+  }
+
+  PortfolioSolver::~PortfolioSolver()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      {
+        delete backends[i]->s;
+        delete backends[i];
+      }
+    pthread_cond_destroy(&finished);
+    pthread_mutex_destroy(&lock);
+  }
+
+  void
+  PortfolioSolver::setSolver(int i, SATSolver* s, bool handlesArrays)
+  {
+    assert(backends[i]->s == NULL);
+    backends[i]->s = s;
+    backends[i]->handlesArrays = handlesArrays;
+  }
+
+  // CMS2 uses different literal values to the other solvers.
+  SATSolver::lbool
+  PortfolioSolver::translate(SATSolver* from, lbool v) const
+  {
+    if (v == from->true_literal())
+      return ((uint8_t)0);
+    if (v == from->false_literal())
+      return ((uint8_t)1);
+    return ((uint8_t)2);
+  }
+
+  bool
+  PortfolioSolver::definite(const Backend& b) const
+  {
+    if (b.result == b.s->false_literal())
+      return true;
+    return (b.result == b.s->true_literal()) && (b.handlesArrays || !arraysAdded);
+  }
+
+  void*
+  PortfolioSolver::race(void* arg)
+  {
+    Backend* b = (Backend*) arg;
+    PortfolioSolver* p = b->owner;
+
+    const lbool r = b->s->solveLimited(*p->assumptions);
+
+    pthread_mutex_lock(&p->lock);
+    b->result = r;
+    b->running = false;
+    if (p->winner == NULL && p->definite(*b))
+      p->winner = b;
+    pthread_cond_signal(&p->finished);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+  }
+
+  SATSolver::lbool
+  PortfolioSolver::runRace(const vec_literals& assumps)
+  {
+    winner = NULL;
+    assumptions = &assumps;
+
+    for (int i = 0; i < backends.size(); i++)
+      {
+        Backend* b = backends[i];
+        b->stop = false;
+        b->running = true;
+        b->result = b->s->undef_literal();
+      }
+
+    for (int i = 0; i < backends.size(); i++)
+      if (0 != pthread_create(&backends[i]->thread, NULL, race, backends[i]))
+        {
+          perror("PortfolioSolver: couldn't create thread");
+          exit(1);
+        }
+
+    pthread_mutex_lock(&lock);
+    while (winner == NULL)
+      {
+        bool running = false;
+        for (int i = 0; i < backends.size(); i++)
+          running |= backends[i]->running;
+        if (!running)
+          break;
+
+        // The interrupt flag isn't signalled, so poll it.
+        if (interrupt_flag)
+          for (int i = 0; i < backends.size(); i++)
+            backends[i]->stop = true;
+
+        timeval now;
+        gettimeofday(&now, NULL);
+        timespec until;
+        until.tv_sec = now.tv_sec;
+        until.tv_nsec = (now.tv_usec + 10 * 1000) * 1000;
+        if (until.tv_nsec >= 1000 * 1000 * 1000)
+          {
+            until.tv_sec++;
+            until.tv_nsec -= 1000 * 1000 * 1000;
+          }
+        pthread_cond_timedwait(&finished, &lock, &until);
+      }
+    pthread_mutex_unlock(&lock);
+
+    // Cancel the losers.
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->stop = true;
+
+    for (int i = 0; i < backends.size(); i++)
+      pthread_join(backends[i]->thread, NULL);
+
+    assumptions = NULL;
+
+    if (winner == NULL)
+      return undef_literal();
+
+    return translate(winner->s, winner->result);
+  }
+
+  bool
+  PortfolioSolver::addClause(const vec_literals& ps) // Add a clause to all the solvers.
+  {
+    bool result = true;
+    for (int i = 0; i < backends.size(); i++)
+      result &= backends[i]->s->addClause(ps);
+    return result;
+  }
+
+  bool
+  PortfolioSolver::addArray(int array_id, const SATSolver::vec_literals& i, const SATSolver::vec_literals& v, const Minisat::vec<Minisat::lbool> & ki, const Minisat::vec<Minisat::lbool> & kv )
+  {
+    arraysAdded = true;
+    for (int j = 0; j < backends.size(); j++)
+      if (backends[j]->handlesArrays)
+        backends[j]->s->addArray(array_id, i, v, ki, kv);
+    return true;
+  }
+
+  bool
+  PortfolioSolver::okay() const // FALSE means solver is in a conflicting state
+  {
+    for (int i = 0; i < backends.size(); i++)
+      if (!backends[i]->s->okay())
+        return false;
+    return true;
+  }
+
+  bool
+  PortfolioSolver::solve() // Search without assumptions.
+  {
+    vec_literals none;
+    return solve(none);
+  }
+
+  bool
+  PortfolioSolver::solve(const vec_literals& assumps) // Search under assumptions.
+  {
+    budgetOff();
+    return runRace(assumps) == true_literal();
+  }
+
+  SATSolver::lbool
+  PortfolioSolver::solveLimited(const vec_literals& assumps) // Search under assumptions, within the budgets.
+  {
+    return runRace(assumps);
+  }
+
+  void PortfolioSolver::setConflictBudget(int64_t x)
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->s->setConflictBudget(x);
+  }
+
+  void PortfolioSolver::setPropagationBudget(int64_t x)
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->s->setPropagationBudget(x);
+  }
+
+  void PortfolioSolver::budgetOff()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->s->budgetOff();
+  }
+
+  void PortfolioSolver::interrupt()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->stop = true;
+  }
+
+  void PortfolioSolver::clearInterrupt()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->stop = false;
+  }
+
+  uint8_t
+  PortfolioSolver::modelValue(Var x) const
+  {
+    if (winner == NULL)
+      return ((uint8_t)2);
+    return translate(winner->s, winner->s->modelValue(x));
+  }
+
+  SATSolver::Var
+  PortfolioSolver::newVar()
+  {
+    Var v = backends[0]->s->newVar();
+    for (int i = 1; i < backends.size(); i++)
+      {
+        const Var other = backends[i]->s->newVar();
+        assert(other == v);
+      }
+    return v;
+  }
+
+  int PortfolioSolver::setVerbosity(int v)
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->s->setVerbosity(v);
+    return v;
+  }
+
+  int PortfolioSolver::nVars()
+  {
+    return backends[0]->s->nVars();
+  }
+
+  void PortfolioSolver::printStats()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      if (backends[i] == winner)
+        {
+          printf("portfolio winner      : %d of %d\n", i, (int) backends.size());
+          winner->s->printStats();
+        }
+  }
+
+  // Each solver gets a different seed.
+  void PortfolioSolver::setSeed(int i)
+  {
+    for (int j = 0; j < backends.size(); j++)
+      backends[j]->s->setSeed(i + j);
+  }
+
+  void PortfolioSolver::setFrozen(Var x)
+  {
+    for (int i = 0; i < backends.size(); i++)
+      backends[i]->s->setFrozen(x);
+  }
+
+  bool PortfolioSolver::eliminatesVariables()
+  {
+    for (int i = 0; i < backends.size(); i++)
+      if (backends[i]->s->eliminatesVariables())
+        return true;
+    return false;
+  }
+};
@@ -0,0 +1,110 @@
+/*
+ * Races several SAT solvers on the same clauses, each in its own thread.
+ * The first definite answer wins, and the model is read from the winner.
+ */
+#ifndef PORTFOLIOSOLVER_H_
+#define PORTFOLIOSOLVER_H_
+
+#include "SATSolver.h"
+#include <vector>
+#include <pthread.h>
+
+namespace BEEV
+{
+  class PortfolioSolver : public SATSolver
+  {
+    struct Backend
+    {
+      SATSolver* s;
+      bool handlesArrays;     // Has an array propagator.
+      volatile bool stop;     // The flag the solver was created with.
+      lbool result;           // In the solver's own literal values.
+      bool running;
+      pthread_t thread;
+      PortfolioSolver* owner;
+    };
+
+    std::vector<Backend*> backends;
+
+    // Stops every backend, e.g. the soft timeout.
+    volatile bool& interrupt_flag;
+
+    // A solver without an array propagator can't be trusted when it says
+    // satisfiable once arrays have been added. Its unsatisfiable answers are fine.
+    bool arraysAdded;
+
+    // Protects winner and the "running" flags while racing.
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    Backend* winner;
+
+    const vec_literals* assumptions;
+
+    static void* race(void* b);
+    lbool runRace(const vec_literals& assumps);
+    lbool translate(SATSolver* from, lbool v) const;
+    bool definite(const Backend& b) const;
+
+  public:
+    // "size" solvers will be added. "interrupt" stops all of them.
+    PortfolioSolver(volatile bool& interrupt, int size);
+
+    ~PortfolioSolver();
+
+    // The flag that the i-th solver must be created with.
+    volatile bool& stopFlag(int i)
+    {
+      return backends[i]->stop;
+    }
+
+    // Takes ownership of the solver.
+    void setSolver(int i, SATSolver* s, bool handlesArrays);
+
+    bool
+    addClause(const vec_literals& ps); // Add a clause to all the solvers.
+
+    bool addArray(int array_id, const SATSolver::vec_literals& i, const SATSolver::vec_literals& v, const Minisat::vec<Minisat::lbool>&, const Minisat::vec<Minisat::lbool> &);
+
+    bool
+    okay() const; // FALSE means solver is in a conflicting state
+
+    bool
+    solve(); // Search without assumptions.
+
+    bool
+    solve(const vec_literals& assumps); // Search under assumptions.
+
+    lbool
+    solveLimited(const vec_literals& assumps); // Search under assumptions, within the budgets.
+
+    void setConflictBudget(int64_t x);
+    void setPropagationBudget(int64_t x);
+    void budgetOff();
+
+    void interrupt();
+    void clearInterrupt();
+
+    virtual uint8_t modelValue(Var x) const;
+
+    virtual Var newVar();
+
+    int setVerbosity(int v);
+
+    int nVars();
+
+    void printStats();
+
+    virtual void setSeed(int i);
+
+    virtual void setFrozen(Var x);
+
+    virtual bool eliminatesVariables();
+
+    virtual lbool true_literal() {return ((uint8_t)0);}
+    virtual lbool false_literal()  {return ((uint8_t)1);}
+    virtual lbool undef_literal()  {return ((uint8_t)2);}
+  };
+}
+;
+
+#endif
@@ -28,6 +28,35 @@ namespace BEEV
     virtual bool
     addClause(const SATSolver::vec_literals& ps)=0; // Add a clause to the solver.
 
+    // Adds the clause lits[0], ..., lits[size-1]. Minisat, Cryptominisat
+    // and ABC's CNF all lay a literal out as var+var+sign, so callers can
+    // pass their own arrays without converting them. The array isn't kept.
+    virtual bool
+    addClause(const Minisat::Lit* lits, int size)
+    {
+      vec_literals ps;
+      for (int i = 0; i < size; i++)
+        ps.push(lits[i]);
+      return addClause(ps);
+    }
+
+    // Whether addXorClause() can be called.
+    virtual bool
+    acceptsXorClauses()
+    {
+      return false;
+    }
+
+    // Adds the constraint that an odd number of the literals are true. The
+    // solver keeps it as it is, rather than as the 2^(n-1) clauses it would
+    // take otherwise.
+    virtual bool
+    addXorClause(const SATSolver::vec_literals& ps)
+    {
+      std::cerr << "XOR clauses are not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
     virtual
     bool addArray(int array_id, const SATSolver::vec_literals& i, const SATSolver::vec_literals& v, const Minisat::vec<Minisat::lbool>&, const Minisat::vec<Minisat::lbool>& )
     {
@@ -42,9 +71,56 @@ namespace BEEV
     virtual bool
     solve()=0; // Search without assumptions.
 
+    // Search for a model that respects the assumptions. Learnt clauses are
+    // kept, so the solver can be called again after more clauses are added.
+    virtual bool
+    solve(const vec_literals& assumps)
+    {
+      std::cerr << "Solving under assumptions is not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
     typedef int Var;
     typedef uint8_t lbool;
 
+    // Like solve(assumps), but gives up if the budget runs out or it's
+    // interrupted. Returns true_literal(), false_literal(), or undef_literal()
+    // if it gave up.
+    virtual lbool
+    solveLimited(const vec_literals& assumps)
+    {
+      std::cerr << "Budgeted solving is not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
+    // Budgets for the next solveLimited() call. Counted from now.
+    virtual void setConflictBudget(int64_t x)
+    {
+      std::cerr << "Budgets are not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
+    virtual void setPropagationBudget(int64_t x)
+    {
+      std::cerr << "Budgets are not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
+    virtual void budgetOff()
+    {}
+
+    // Sets the interrupt flag the solver was created with. The search stops
+    // soon after. Only writes a volatile bool, so it's safe to call from
+    // another thread or a signal handler.
+    virtual void interrupt()
+    {
+      std::cerr << "Interrupting is not implemented for this solver" << std::endl;
+      exit(1);
+    }
+
+    virtual void clearInterrupt()
+    {}
+
     static inline  Minisat::Lit  mkLit     (Var var, bool sign) { Minisat::Lit p; p.x = var + var + (int)sign; return p; }
 
     virtual uint8_t   modelValue (Var x) const = 0;
@@ -71,6 +147,13 @@ namespace BEEV
     virtual void setFrozen(Var x)
     {}
 
+    // Whether variables that aren't frozen can be eliminated when solving,
+    // so later clauses mustn't mention them.
+    virtual bool eliminatesVariables()
+    {
+      return false;
+    }
+
     virtual int nClauses()
     {
       std::cerr << "Not yet implemented.";
@@ -17,7 +17,18 @@ namespace BEEV
   bool
   SimplifyingMinisat::addClause(const vec_literals& ps) // Add a clause to the solver.
   {
-    s->addClause(ps);
+    return s->addClause(ps);
+  }
+
+  bool
+  SimplifyingMinisat::addClause(const Minisat::Lit* lits, int size)
+  {
+    // addClause(ps) would copy ps again before adding it.
+    buffer.clear();
+    buffer.capacity(size);
+    for (int i = 0; i < size; i++)
+      buffer.push_(lits[i]);
+    return s->addClause_(buffer);
   }
 
   bool
@@ -35,6 +46,49 @@ namespace BEEV
     return s->solve();
   }
 
+  bool
+  SimplifyingMinisat::solve(const vec_literals& assumps) // Search under assumptions.
+  {
+    if (!s->simplify())
+      return false;
+
+    return s->solve(assumps);
+  }
+
+  SATSolver::lbool
+  SimplifyingMinisat::solveLimited(const vec_literals& assumps) // Search under assumptions, within the budgets.
+  {
+    if (!s->simplify())
+      return false_literal();
+
+    return Minisat::toInt(s->solveLimited(assumps));
+  }
+
+  void SimplifyingMinisat::setConflictBudget(int64_t x)
+  {
+    s->setConfBudget(x);
+  }
+
+  void SimplifyingMinisat::setPropagationBudget(int64_t x)
+  {
+    s->setPropBudget(x);
+  }
+
+  void SimplifyingMinisat::budgetOff()
+  {
+    s->budgetOff();
+  }
+
+  void SimplifyingMinisat::interrupt()
+  {
+    s->interrupt();
+  }
+
+  void SimplifyingMinisat::clearInterrupt()
+  {
+    s->clearInterrupt();
+  }
+
   bool
   SimplifyingMinisat::simplify() // Removes already satisfied clauses.
   {
@@ -50,6 +104,7 @@ namespace BEEV
   int SimplifyingMinisat::setVerbosity(int v)
   {
     s->verbosity = v;
+    return v;
   }
 
   void SimplifyingMinisat::setSeed(int i)
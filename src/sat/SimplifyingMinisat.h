@@ -16,6 +16,7 @@ namespace BEEV
   class SimplifyingMinisat : public SATSolver
   {
     Minisat::SimpSolver* s;
+    vec_literals buffer; // Reused by addClause(lits, size).
 
   public:
 
@@ -25,12 +26,28 @@ namespace BEEV
     bool
     addClause(const vec_literals& ps); // Add a clause to the solver.
 
+    bool
+    addClause(const Minisat::Lit* lits, int size);
+
     bool
     okay() const; // FALSE means solver is in a conflicting state
 
     bool
     solve(); // Search without assumptions.
 
+    bool
+    solve(const vec_literals& assumps); // Search under assumptions.
+
+    lbool
+    solveLimited(const vec_literals& assumps); // Search under assumptions, within the budgets.
+
+    void setConflictBudget(int64_t x);
+    void setPropagationBudget(int64_t x);
+    void budgetOff();
+
+    void interrupt();
+    void clearInterrupt();
+
     bool
     simplify(); // Removes already satisfied clauses.
 
@@ -51,6 +68,11 @@ namespace BEEV
     virtual lbool undef_literal()  {return ((uint8_t)2);}
 
     virtual void setFrozen(Var x);
+
+    virtual bool eliminatesVariables()
+    {
+      return true;
+    }
  };
 }
 ;
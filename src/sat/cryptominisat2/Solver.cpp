@@ -136,6 +136,9 @@ Solver::Solver() :
         , dynamic_behaviour_analysis(false) //do not document the proof as default
         #endif
         , maxRestarts(UINT_MAX)
+        , conflict_budget(-1)
+        , propagation_budget(-1)
+        , asynch_interrupt(NULL)
         , MYFLAG           (0)
         , learnt_clause_group(0)
         , libraryCNFFile   (NULL)
@@ -1495,6 +1498,33 @@ void Solver::setMaxRestarts(const uint num)
     maxRestarts = num;
 }
 
+void Solver::setConfBudget(const int64_t x)
+{
+    conflict_budget = conflicts + x;
+}
+
+void Solver::setPropBudget(const int64_t x)
+{
+    propagation_budget = propagations + x;
+}
+
+void Solver::budgetOff()
+{
+    conflict_budget = propagation_budget = -1;
+}
+
+void Solver::setInterrupt(volatile bool* flag)
+{
+    asynch_interrupt = flag;
+}
+
+bool Solver::withinBudget() const
+{
+    return (asynch_interrupt == NULL || !*asynch_interrupt) &&
+           (conflict_budget < 0 || conflicts < (uint64_t)conflict_budget) &&
+           (propagation_budget < 0 || propagations < (uint64_t)propagation_budget);
+}
+
 inline int64_t abs64(int64_t a)
 {
     if (a < 0) return -a;
@@ -1640,6 +1670,12 @@ lbool Solver::search(int nof_conflicts, int nof_conflicts_fullrestart, const boo
 llbool Solver::new_decision(const int& nof_conflicts, const int& nof_conflicts_fullrestart, int& conflictC)
 {
     
+    // Out of budget, or interrupted?
+    if (!withinBudget()) {
+        cancelUntil(0);
+        return l_Undef;
+    }
+
     // Reached bound on number of conflicts?
     switch (restartType) {
     case dynamic_restart:
@@ -2188,7 +2224,7 @@ lbool Solver::solve(const vec<Lit>& assumps)
     calculateDefaultPolarities();
     
     // Search:
-    while (status == l_Undef && starts < maxRestarts) {
+    while (status == l_Undef && starts < maxRestarts && withinBudget()) {
         #ifdef DEBUG_VARELIM
         assert(subsumer->checkElimedUnassigned());
         assert(xorSubsumer->checkElimedUnassigned());
@@ -196,6 +196,10 @@ public:
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
     void    setSeed (const uint32_t seed);  // Sets the seed to be the given number
     void    setMaxRestarts(const uint num); //sets the maximum number of restarts to given value
+    void    setConfBudget(const int64_t x); // Give up after this many more conflicts
+    void    setPropBudget(const int64_t x); // Give up after this many more propagations
+    void    budgetOff();                    // No limits
+    void    setInterrupt(volatile bool* flag); // Give up when this flag is set (it can be set from another thread)
 
     // Read state:
     //
@@ -389,6 +393,10 @@ protected:
     bool                dynamic_behaviour_analysis; // Is logger running?
     #endif
     uint                maxRestarts;      // More than this number of restarts will not be performed
+    int64_t             conflict_budget;    // -1 means no budget.
+    int64_t             propagation_budget; // -1 means no budget.
+    volatile bool*      asynch_interrupt;   // NULL if the search can't be interrupted
+    bool                withinBudget() const;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
     // used, exept 'seen' wich is used in several places.
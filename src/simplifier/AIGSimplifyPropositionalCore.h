@@ -3,9 +3,9 @@
  * then converts it back to ASTNodes.
  *
  *
- *  This has two problems: 1) It doesn't consider that the propositional variables that are introduced,
+ *  This has a problem: It doesn't consider that the propositional variables that are introduced,
  *  might actually represent many thousands of AIG nodes, so it doesn't do the "DAG aware" part correctly.
- *  2) The startup of the DAR takes about 150M instructions, which is agggeeesss for small problems.
+ *  (The DAR library is read once per process, so its startup isn't paid on each call.)
  */
 
 #ifndef AIGSIMPLIFYPROPOSITIONALCORE_H_
@@ -136,7 +136,7 @@ public:
     	int initial_nodeCount = mgr.aigMgr->nObjs[AIG_OBJ_AND];
    		//cerr << "Nodes before AIG rewrite:" << initial_nodeCount << endl;
 
-		Dar_LibStart();  // About 150M instructions. Very expensive.
+		Dar_LibStart();
 		Aig_Man_t * pTemp;
 		Dar_RwrPar_t Pars, *pPars = &Pars;
 		Dar_ManDefaultRwrParams(pPars);
@@ -9,6 +9,4 @@
 namespace BEEV
 {
 
-  vector<MutableASTNode*> MutableASTNode::all;
-
 };
@@ -14,7 +14,8 @@ namespace BEEV
 {
   class MutableASTNode
   {
-    static vector<MutableASTNode*> all;
+    // Every node in the same graph as this one, so they can be deleted together.
+    vector<MutableASTNode*>* all;
 
   public:
     typedef set<MutableASTNode *> ParentsType;
@@ -25,8 +26,8 @@ private:
     MutableASTNode&
     operator=(const MutableASTNode &); // No definition
 
-    MutableASTNode(const ASTNode& n_) :
-      n(n_)
+    MutableASTNode(const ASTNode& n_, vector<MutableASTNode*>* all_) :
+      all(all_), n(n_)
     {
       dirty = false;
     }
@@ -34,9 +35,8 @@ private:
     // Make a mutable ASTNode graph like the ASTNode one, but with pointers back up too.
     // It's convoluted because we want a post order traversal. The root node of a sub-tree
     // will be created after its children.
-public:
     static MutableASTNode *
-    build(const ASTNode& n, map<ASTNode, MutableASTNode *> & visited)
+    build(const ASTNode& n, map<ASTNode, MutableASTNode *> & visited, vector<MutableASTNode*>* all)
     {
       if (visited.find(n) != visited.end())
         {
@@ -47,9 +47,9 @@ public:
       tempChildren.reserve(n.Degree());
 
       for (int i = 0; i < n.Degree(); i++)
-        tempChildren.push_back(build(n[i], visited));
+        tempChildren.push_back(build(n[i], visited, all));
 
-      MutableASTNode * mut = createNode(n);
+      MutableASTNode * mut = createNode(n, all);
 
       for (int i = 0; i < n.Degree(); i++)
         tempChildren[i]->parents.insert(mut);
@@ -145,10 +145,10 @@ private:
     vector<MutableASTNode *> children;
 
     static MutableASTNode *
-    createNode(ASTNode n)
+    createNode(ASTNode n, vector<MutableASTNode*>* all)
     {
-      MutableASTNode * result = new MutableASTNode(n);
-      all.push_back(result);
+      MutableASTNode * result = new MutableASTNode(n, all);
+      all->push_back(result);
       return result;
     }
 
@@ -163,11 +163,19 @@ private:
       return result;
     }
 
+    // Builds a new graph.
     static MutableASTNode *
     build(ASTNode n)
     {
       map<ASTNode, MutableASTNode *> visited;
-      return build(n, visited);
+      return build(n, visited, new vector<MutableASTNode*>());
+    }
+
+    // Adds to the graph this node is in.
+    MutableASTNode *
+    build(const ASTNode& n, map<ASTNode, MutableASTNode *> & visited)
+    {
+      return build(n, visited, all);
     }
 
     void
@@ -233,9 +241,10 @@ private:
     }
 
     // Variables that have >1 disjoint extract parents.
-    static void
+    void
     getDisjointExtractVariables(vector<MutableASTNode*> & result)
     {
+      vector<MutableASTNode*>& all = *this->all;
       const int size = all.size();
       for (int i = size-1; i >=0 ; i--)
         {
@@ -290,9 +299,10 @@ private:
     // Visit the parent before children. So that we hopefully prune parts of the
     // tree. Ie given  ( F(x_1,... x_10000) = v), where v is unconstrained,
     // we don't spend time exploring F(..), but chop it out.
-    static void
+    void
     getAllUnconstrainedVariables(vector<MutableASTNode*> & result)
     {
+      vector<MutableASTNode*>& all = *this->all;
       const int size = all.size();
       for (int i = size-1; i >=0 ; i--)
         {
@@ -327,12 +337,14 @@ private:
       return parents.size() == 1;
     }
 
-    static void
+    // Deletes every node in the graph, including this one.
+    void
     cleanup()
     {
-      for (int i = 0; i < all.size(); i++)
-        delete all[i];
-      all.clear();
+      vector<MutableASTNode*>* graph = all;
+      for (int i = 0; i < graph->size(); i++)
+        delete (*graph)[i];
+      delete graph;
     }
   };
 
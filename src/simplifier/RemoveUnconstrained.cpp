@@ -17,6 +17,7 @@ namespace BEEV
     bm(_bm)
   {
     nf = _bm.defaultNodeFactory;
+    simplifier_convenient = NULL;
  }
 
   const bool debug_unconstrained = false;
@@ -62,8 +63,6 @@ namespace BEEV
       return true;
   }
 
-  Simplifier *simplifier_convenient;
-
   ASTNode RemoveUnconstrained::replaceParentWithFresh(MutableASTNode& mute, vector<MutableASTNode*>& variables)
   {
       const ASTNode& parent = mute.n;
@@ -412,7 +411,7 @@ namespace BEEV
                       n= nf->CreateNode(AND, v, nf->CreateNode(NOT,nf->CreateNode(EQ, mutable_children[0]->toASTNode(nf), c2)));
                   }
                 replace(var, rhs);
-                MutableASTNode *newN = MutableASTNode::build(n,create);
+                MutableASTNode *newN = topMutable->build(n,create);
                 muteParent.replaceWithAnotherNode(newN);
                 //assert(muteParent.checkInvariant());
               }
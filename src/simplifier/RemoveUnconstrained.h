@@ -39,6 +39,9 @@ namespace BEEV
 
     NodeFactory* nf;
 
+    // The simplifier that replace() records substitutions in.
+    Simplifier *simplifier_convenient;
+
   public:
 
     RemoveUnconstrained(STPMgr& bm);
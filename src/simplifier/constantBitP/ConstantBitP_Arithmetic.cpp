@@ -9,6 +9,50 @@ namespace simplifier
 namespace constantBitP
 {
 
+typedef FixedBits::Word Word;
+
+// Fixes "output" to "a + b", or if "subtract", to "a - b". A word at a time.
+// "a" and "b" must be totally fixed.
+static Result fixToSum(const FixedBits& a, const FixedBits& b, FixedBits& output, const bool subtract)
+{
+	assert(a.isTotallyFixed() && b.isTotallyFixed());
+	assert(a.getWidth() == output.getWidth() && b.getWidth() == output.getWidth());
+
+	Result result = NO_CHANGE;
+	Word carry = subtract ? 1 : 0; // a - b == a + ~b + 1
+
+	for (int w = 0; w < output.numberOfWords(); w++)
+	{
+		const Word bw = subtract ? ~b.getValueWord(w) : b.getValueWord(w);
+		const Word partial = a.getValueWord(w) + bw;
+		const Word sum = partial + carry;
+		carry = (partial < bw || sum < partial) ? 1 : 0;
+
+		const Word unfixed = ~output.getFixedWord(w) & output.wordMask(w);
+		if ((output.getFixedWord(w) & (output.getValueWord(w) ^ sum)) != 0)
+			return CONFLICT;
+		if (unfixed != 0)
+		{
+			output.fixWord(w, unfixed, sum);
+			result = CHANGED;
+		}
+	}
+	return result;
+}
+
+// When all but one of a + b == output are totally fixed, the other one is
+// known. Returns NOT_IMPLEMENTED if they aren't fixed enough.
+static Result fixLastOfSum(FixedBits& a, FixedBits& b, FixedBits& output)
+{
+	if (a.isTotallyFixed() && b.isTotallyFixed())
+		return fixToSum(a, b, output, false);
+	if (output.isTotallyFixed() && a.isTotallyFixed())
+		return fixToSum(output, a, b, true);
+	if (output.isTotallyFixed() && b.isTotallyFixed())
+		return fixToSum(output, b, a, true);
+	return NOT_IMPLEMENTED;
+}
+
 // Subtract is implemented in terms of plus.
 Result bvSubtractBothWays(vector<FixedBits*>& children, FixedBits& output)
 {
@@ -21,6 +65,13 @@ Result bvSubtractBothWays(vector<FixedBits*>& children, FixedBits& output)
 
 	const int bitWidth = a.getWidth();
 
+	// a - b == output is the same as output + b == a.
+	const Result fast = fixLastOfSum(output, b, a);
+	if (CONFLICT == fast)
+		return CONFLICT;
+	if (NOT_IMPLEMENTED != fast)
+		return NOT_IMPLEMENTED;
+
 	FixedBits one(bitWidth, false);
 	one.fixToZero();
 	one.setFixed(0, true);
@@ -225,6 +276,12 @@ void setValue(FixedBits& a, const int i, bool v)
     Result
     bvAddBothWays(FixedBits& x, FixedBits& y, FixedBits& output)
     {
+      const Result fast = fixLastOfSum(x, y, output);
+      if (CONFLICT == fast)
+        return CONFLICT;
+      if (NOT_IMPLEMENTED != fast)
+        return NOT_IMPLEMENTED;
+
       const int bitWidth = output.getWidth();
       FixedBits carry(bitWidth + 1, false);
       carry.setFixed(0, true);
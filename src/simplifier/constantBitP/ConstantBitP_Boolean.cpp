@@ -11,40 +11,38 @@ namespace simplifier
 namespace constantBitP
 {
 
+// The transfer functions work on a word of columns at a time.
+typedef FixedBits::Word Word;
+
 Result bvXorBothWays(vector<FixedBits*>& operands, FixedBits& output)
 {
 	Result result = NO_CHANGE;
-	const int bitWidth = output.getWidth();
 
-	for (int i = 0; i < bitWidth; i++)
+	for (int w = 0; w < output.numberOfWords(); w++)
 	{
-		const stats status = getStats(operands, i);
+		const wordStats status = getWordStats(operands, w);
+		const Word outF = output.getFixedWord(w);
+		const Word outV = output.getValueWord(w);
+		const Word mask = output.wordMask(w);
+
+		// if they are all fixed. We know the answer.
+		const Word known = status.noneUnfixed & mask;
+		if ((known & outF & (outV ^ status.oddOnes)) != 0)
+			return CONFLICT;
 
-		if (status.unfixed == 0) // if they are all fixed. We know the answer.
+		if ((known & ~outF) != 0)
 		{
-			bool answer = (status.fixedToOne % 2) != 0;
-
-			if (!output.isFixed(i))
-			{
-				output.setFixed(i, true);
-				output.setValue(i, answer);
-				result = CHANGED;
-			}
-			else if (output.getValue(i) != answer)
-				return CONFLICT;
-		}
-		else if (status.unfixed == 1 && output.isFixed(i))
-		{
-			// If there is just one unfixed, and we have the answer --> We know the value.
-			bool soFar = ((status.fixedToOne % 2) != 0);
-			if (soFar != output.getValue(i))
-			{ // result needs to be flipped.
-				fixUnfixedTo(operands, i, true);
-			}
-			else
-				fixUnfixedTo(operands, i, false);
+			output.fixWord(w, known & ~outF, status.oddOnes);
 			result = CHANGED;
 		}
+
+		// If there is just one unfixed, and we have the answer --> We know the value.
+		// It's flipped if the answer so far is different.
+		const Word single = status.oneUnfixed & outF & mask;
+		if (fixUnfixedWordTo(operands, w, single & (status.oddOnes ^ outV), true))
+			result = CHANGED;
+		if (fixUnfixedWordTo(operands, w, single & ~(status.oddOnes ^ outV), false))
+			result = CHANGED;
 	}
 	return result;
 }
@@ -55,50 +53,37 @@ Result bvXorBothWays(vector<FixedBits*>& operands, FixedBits& output)
 Result bvAndBothWays(vector<FixedBits*>& operands, FixedBits& output)
 {
 	Result result = NO_CHANGE;
-	const int bitWidth = output.getWidth();
 
-	for (int i = 0; i < bitWidth; i++)
+	for (int w = 0; w < output.numberOfWords(); w++)
 	{
-		const stats status = getStats(operands, i);
+		const wordStats status = getWordStats(operands, w);
+		const Word mask = output.wordMask(w);
+		const Word outOne = output.getOnesWord(w);
+		const Word outZero = output.getZeroesWord(w);
+		const Word outUnfixed = ~output.getFixedWord(w) & mask;
 
 		// output is fixed to one. But an input value is false!
-		if (output.isFixed(i) && output.getValue(i) && status.fixedToZero > 0)
+		if ((outOne & status.someZero) != 0)
 			return CONFLICT;
 
-		// output is fixed to one. But an input value is false!
-		if (output.isFixed(i) && !output.getValue(i) && status.fixedToZero == 0
-				&& status.unfixed == 0)
+		// output is fixed to zero. But all the inputs are true!
+		if ((outZero & ~status.someZero & status.noneUnfixed) != 0)
 			return CONFLICT;
 
 		// output is fixed to one. So all should be one.
-		if (output.isFixed(i) && output.getValue(i) && status.unfixed > 0)
-		{
-			fixUnfixedTo(operands, i, true);
-			result = CHANGED;
-		}
-
-		// The output is unfixed. At least one input is false.
-		if (!output.isFixed(i) && status.fixedToZero > 0)
-		{
-			output.setFixed(i, true);
-			output.setValue(i, false);
+		if (fixUnfixedWordTo(operands, w, outOne, true))
 			result = CHANGED;
-		}
 
-		// Everything is fixed to one!
-		if (!output.isFixed(i) && status.fixedToZero == 0 && status.unfixed
-				== 0)
-		{
-			output.setFixed(i, true);
-			output.setValue(i, true);
+		// If the output is false, and there is a single unfixed value with everything else true..
+		if (fixUnfixedWordTo(operands, w, outZero & ~status.someZero & status.oneUnfixed, false))
 			result = CHANGED;
-		}
 
-		// If the output is false, and there is a single unfixed value with everything else true..
-		if (output.isFixed(i) && !output.getValue(i) && status.fixedToZero == 0
-				&& status.unfixed == 1)
+		// The output is unfixed. At least one input is false, or everything is fixed to one!
+		const Word toZero = outUnfixed & status.someZero;
+		const Word toOne = outUnfixed & ~status.someZero & status.noneUnfixed;
+		if ((toZero | toOne) != 0)
 		{
-			fixUnfixedTo(operands, i, false);
+			output.fixWord(w, toZero | toOne, toOne);
 			result = CHANGED;
 		}
 	}
@@ -108,97 +93,38 @@ Result bvAndBothWays(vector<FixedBits*>& operands, FixedBits& output)
 Result bvOrBothWays(vector<FixedBits*>& children, FixedBits& output)
 {
 	Result r = NO_CHANGE;
-	const int numberOfChildren = children.size();
-	const int bitWidth = output.getWidth();
-
-	for (int i = 0; i < bitWidth; i++)
-	{
-		bool answerKnown = output.isFixed(i);
-		bool answer = false;
-		if (answerKnown)
-			answer = output.getValue(i);
-
-		int unks = 0;
-		int ones = 0;
-		int zeroes = 0;
-
-		for (int j = 0; j < numberOfChildren; j++)
-		{
-			assert(output.getWidth() == children[j]->getWidth());
-
-			if (!children[j]->isFixed(i))
-				unks++;
-			else if (children[j]->getValue(i))
-				ones++;
-			else
-				zeroes++;
-		}
-
-		if (ones > 0) // Atleast a single one found!
-
-		{
-			if (answerKnown && !answer)
-				return CONFLICT;
-
-			if (!answerKnown)
-			{
-				output.setFixed(i, true);
-				output.setValue(i, true);
-				r = CHANGED;
-			}
-		}
-
-		if (zeroes == numberOfChildren) // all zeroes.
-
-		{
-			if (answerKnown && answer)
-				return CONFLICT;
-
-			if (!answerKnown)
-			{
-				r = CHANGED;
-				output.setFixed(i, true);
-				output.setValue(i, false);
 
-			}
-		}
+	for (unsigned j = 0; j < children.size(); j++)
+		assert(output.getWidth() == children[j]->getWidth());
 
-		if (answerKnown && !answer) // known false
+	for (int w = 0; w < output.numberOfWords(); w++)
+	{
+		const wordStats status = getWordStats(children, w);
+		const Word mask = output.wordMask(w);
+		const Word outOne = output.getOnesWord(w);
+		const Word outZero = output.getZeroesWord(w);
+		const Word outUnfixed = ~output.getFixedWord(w) & mask;
+		const Word allZeroes = status.noneUnfixed & ~status.someOne & mask;
+
+		// At least a single one found, or all zeroes.
+		if ((outZero & status.someOne) != 0 || (outOne & allZeroes) != 0)
+			return CONFLICT;
 
+		const Word toOne = outUnfixed & status.someOne;
+		const Word toZero = outUnfixed & allZeroes;
+		if ((toOne | toZero) != 0)
 		{
-			if (ones > 0)
-				return CONFLICT;
-
-			// set all the column to false.
-
-			for (int j = 0; j < numberOfChildren; j++)
-			{
-				if (!children[j]->isFixed(i))
-				{
-					r = CHANGED;
-					children[j]->setFixed(i, true);
-					children[j]->setValue(i, false);
-				}
-			}
-
+			output.fixWord(w, toOne | toZero, toOne);
+			r = CHANGED;
 		}
 
-		if (unks == 1 && answerKnown && answer && (zeroes == (numberOfChildren
-				- 1)))
-		{
-			// A single unknown, everything else is false. The answer is true. So the unknown is true.
-
-			for (int j = 0; j < numberOfChildren; j++)
-			{
-				if (!children[j]->isFixed(i))
-				{
-					r = CHANGED;
-					children[j]->setFixed(i, true);
-					children[j]->setValue(i, true);
-				}
-			}
-		}
+		// known false, set all the column to false.
+		if (fixUnfixedWordTo(children, w, outZero, false))
+			r = CHANGED;
 
+		// A single unknown, everything else is false. The answer is true. So the unknown is true.
+		if (fixUnfixedWordTo(children, w, outOne & status.oneUnfixed & ~status.someOne, true))
+			r = CHANGED;
 	}
 	return r;
 }
@@ -299,30 +225,22 @@ Result bvImpliesBothWays(vector<FixedBits*>& children, FixedBits& result)
 Result bvNotBothWays(FixedBits& a, FixedBits& output)
 {
 	assert(a.getWidth() == output.getWidth());
-	const int bitWidth = a.getWidth();
 
 	Result result = NO_CHANGE;
 
-	for (int i = 0; i < bitWidth; i++)
+	for (int w = 0; w < a.numberOfWords(); w++)
 	{
+		const Word aF = a.getFixedWord(w);
+		const Word outF = output.getFixedWord(w);
+
 		// error if they are the same.
-		if (a.isFixed(i) && output.isFixed(i) && (a.getValue(i)
-				== output.getValue(i)))
-		{
+		if ((aF & outF & ~(a.getValueWord(w) ^ output.getValueWord(w))) != 0)
 			return CONFLICT;
-		}
 
-		if (a.isFixed(i) && !output.isFixed(i))
+		if ((aF ^ outF) != 0)
 		{
-			output.setFixed(i, true);
-			output.setValue(i, !a.getValue(i));
-			result = CHANGED;
-		}
-
-		if (output.isFixed(i) && !a.isFixed(i))
-		{
-			a.setFixed(i, true);
-			a.setValue(i, !output.getValue(i));
+			output.fixWord(w, aF & ~outF, ~a.getValueWord(w));
+			a.fixWord(w, outF & ~aF, ~output.getValueWord(w));
 			result = CHANGED;
 		}
 	}
@@ -104,30 +104,24 @@ void destroy(CBV a, CBV b, CBV c, CBV d)
 }
 
 // Fast exit. Without creating min/max.
+// True if the highest column where they aren't fixed to the same value has
+// both unfixed.
 bool
 fast_exit(FixedBits& c0, FixedBits& c1)
 {
-  for (int i = c0.getWidth() - 1; i >= 0; i--)
+  typedef FixedBits::Word Word;
+  for (int w = c0.numberOfWords() - 1; w >= 0; w--)
     {
-      const char c_0 = c0[i];
-      const char c_1 = c1[i];
-
-      if (c_0 == '0')
-        {
-          if (c_1 == '0')
-            continue;
-        }
-      else if (c_0 == '1')
-        {
-          if (c_1 == '1')
-            continue;
-        }
-      else if (c_0 == '*' && c_1 == '*')
-        {
-          return true;
-        }
-      return false;
+      const Word f0 = c0.getFixedWord(w), f1 = c1.getFixedWord(w);
+      const Word same = f0 & f1 & ~(c0.getValueWord(w) ^ c1.getValueWord(w));
+      const Word different = ~same & c0.wordMask(w);
+      if (different == 0)
+        continue;
+
+      const Word top = ((Word) 1) << (FixedBits::wordBits - 1 - __builtin_clzll(different));
+      return ((f0 | f1) & top) == 0;
     }
+  return false;
 }
 
 
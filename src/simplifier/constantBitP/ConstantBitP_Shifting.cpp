@@ -17,34 +17,96 @@ namespace constantBitP
 
 const bool debug_shift = false;
 
+// The transfer functions work on a word of columns at a time.
+typedef FixedBits::Word Word;
+const int wordBits = FixedBits::wordBits;
+
+// Word "w" of the fixed or value mask. Zero outside the FixedBits.
+static Word maskWord(const FixedBits& a, const bool values, const int w)
+{
+	if (w < 0 || w >= a.numberOfWords())
+		return 0;
+	return values ? a.getValueWord(w) : a.getFixedWord(w);
+}
+
+// Word "w" of a mask shifted towards the most significant end by "s". Zeroes are shifted in.
+static Word shiftUpWord(const FixedBits& a, const bool values, const int w, const unsigned s)
+{
+	const int q = s / wordBits;
+	const int r = s % wordBits;
+	Word result = maskWord(a, values, w - q) << r;
+	if (r != 0)
+		result |= maskWord(a, values, w - q - 1) >> (wordBits - r);
+	return result;
+}
+
+// Word "w" of a mask shifted towards the least significant end by "s". Zeroes are shifted in.
+static Word shiftDownWord(const FixedBits& a, const bool values, const int w, const unsigned s)
+{
+	const int q = s / wordBits;
+	const int r = s % wordBits;
+	Word result = maskWord(a, values, w + q) >> r;
+	if (r != 0)
+		result |= maskWord(a, values, w + q + 1) << (wordBits - r);
+	return result;
+}
+
+// Narrows "agreeF" to the columns that are fixed to the same value in every
+// shifting seen so far.
+static void agree(Word& agreeF, Word& agreeV, const Word f, const Word v, const bool first)
+{
+	if (first)
+	{
+		agreeF = f;
+		agreeV = v & f;
+	}
+	else
+		agreeF &= f & ~(agreeV ^ v);
+}
+
+static Word reverseWord(Word x)
+{
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+	x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+	return (x >> 32) | (x << 32);
+}
+
+// The columns in the opposite order.
+static FixedBits reversed(const FixedBits& a)
+{
+	const int words = a.numberOfWords();
+	const int pad = words * wordBits - a.getWidth();
+
+	FixedBits result(a.getWidth(), a.isBoolean());
+	for (int k = 0; k < words; k++)
+	{
+		Word f = reverseWord(a.getFixedWord(words - 1 - k)) >> pad;
+		Word v = reverseWord(a.getValueWord(words - 1 - k)) >> pad;
+		if (pad != 0 && k + 1 < words)
+		{
+			f |= reverseWord(a.getFixedWord(words - 2 - k)) << (wordBits - pad);
+			v |= reverseWord(a.getValueWord(words - 2 - k)) << (wordBits - pad);
+		}
+		result.fixWord(k, f, v);
+	}
+	return result;
+}
+
 Result bvRightShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 {
 	Result result = NO_CHANGE;
-	const unsigned bitWidth = output.getWidth();
 
 	assert(2 == children.size());
 
 	FixedBits& op = *children[0];
 	FixedBits& shift = *children[1];
 
-	FixedBits outputReverse(bitWidth,false);
-	FixedBits opReverse(bitWidth,false);
-
 	// Reverse the output and the input.
-	for (unsigned i =0; i < bitWidth;i++)
-	{
-		if (op.isFixed(i))
-		{
-			opReverse.setFixed(bitWidth-1-i,true);
-			opReverse.setValue(bitWidth-1-i,op.getValue(i));
-		}
-
-		if (output.isFixed(i))
-		{
-			outputReverse.setFixed(bitWidth-1-i,true);
-			outputReverse.setValue(bitWidth-1-i,output.getValue(i));
-		}
-	}
+	FixedBits outputReverse = reversed(output);
+	FixedBits opReverse = reversed(op);
 
 	vector<FixedBits*> args;
 	args.push_back(&opReverse);
@@ -55,21 +117,8 @@ Result bvRightShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 		return CONFLICT;
 
 	// Now write the reversed values back.
-	// Reverse the output and the input.
-	for (unsigned i =0; i < bitWidth;i++)
-	{
-		if (opReverse.isFixed(i) && !op.isFixed(bitWidth-1-i))
-		{
-			op.setFixed(bitWidth-1-i,true);
-			op.setValue(bitWidth-1-i,opReverse.getValue(i));
-		}
-
-		if (outputReverse.isFixed(i) && !output.isFixed(bitWidth-1-i))
-		{
-			output.setFixed(bitWidth-1-i,true);
-			output.setValue(bitWidth-1-i,outputReverse.getValue(i));
-		}
-	}
+	op.mergeIn(reversed(opReverse));
+	output.mergeIn(reversed(outputReverse));
 
 	return result;
 }
@@ -86,38 +135,13 @@ FixedBits getPossible(unsigned bitWidth, bool possibleShift[], unsigned numberOf
 			if (first)
 			{
 				first = false;
-				for (unsigned j = 0; j < (unsigned) v.getWidth(); j++)
-				{
-					v.setFixed(j, true);
-					if (j < sizeof(unsigned) * 8)
-						v.setValue(j, 0 != (i & (1 << j)));
-					else
-						v.setValue(j, false);
-				}
+				v.fromUnsigned(i);
 			}
 			else
-			{
-				// join.
-				for (unsigned j = 0; j < (unsigned) v.getWidth() && j
-						< sizeof(unsigned) * 8; j++)
-				{
-					if (v.isFixed(j))
-					{
-						// union.
-						if (v.getValue(j) != (0 != (i & (1 << j))))
-							v.setFixed(j, false);
-					}
-				}
-			}
+				v.join(i); // union.
 		}
 	}
 
-	unsigned firstShift;
-	for (firstShift=0; firstShift<numberOfPossibleShifts; firstShift++)
-		if (possibleShift[firstShift])
-			break;
-
-
 	// The top most entry of the shift table is special. It means all values of shift
 	// that fill it completely with zeroes /ones. We take the union of all of the values >bitWidth
 	// in this function.
@@ -138,21 +162,10 @@ FixedBits getPossible(unsigned bitWidth, bool possibleShift[], unsigned numberOf
 		assert(CONFLICT != r);
 
 		// Get the union of "working" with the prior union.
-		for (unsigned i = 0; i < bitWidth; i++)
-		{
-			if (!working.isFixed(i) && v.isFixed(i))
-				v.setFixed(i, false);
-			if (working.isFixed(i) && v.isFixed(i) && (working.getValue(i) != v.getValue(i)))
-				v.setFixed(i, false);
-			if (firstShift == numberOfPossibleShifts - 1) // no less shifts possible.
-			{
-				if (working.isFixed(i))
-				{
-					v.setFixed(i, true);
-					v.setValue(i, working.getValue(i));
-				}
-			}
-		}
+		if (first) // no less shifts possible.
+			v = working;
+		else
+			v.join(working);
 	}
 
 	if (debug_shift)
@@ -161,6 +174,39 @@ FixedBits getPossible(unsigned bitWidth, bool possibleShift[], unsigned numberOf
 	return v;
 }
 
+// Fixes the shift to the set of possible shifts.
+static Result fixShift(FixedBits& shift, const FixedBits& possible)
+{
+	Result result = NO_CHANGE;
+	for (int w = 0; w < shift.numberOfWords(); w++)
+	{
+		const Word f = shift.getFixedWord(w);
+		const Word pF = possible.getFixedWord(w);
+		if ((f & pF & (shift.getValueWord(w) ^ possible.getValueWord(w))) != 0)
+			return CONFLICT;
+		if ((pF & ~f) != 0)
+		{
+			shift.fixWord(w, pF & ~f, possible.getValueWord(w));
+			result = CHANGED;
+		}
+	}
+	return result;
+}
+
+// Fixes the columns of the output that are in "agreeF", and says if any
+// disagree with what's already fixed.
+static Result fixAgreed(FixedBits& output, const int w, const Word agreeF, const Word agreeV)
+{
+	const Word f = output.getFixedWord(w);
+	if ((f & agreeF & (output.getValueWord(w) ^ agreeV)) != 0)
+		return CONFLICT;
+	if ((agreeF & ~f) != 0)
+	{
+		output.fixWord(w, agreeF & ~f, agreeV);
+		return CHANGED;
+	}
+	return NO_CHANGE;
+}
 
 unsigned getMaxShiftFromValueViaAlternation(const unsigned bitWidth, const FixedBits& output)
 {
@@ -334,34 +380,33 @@ Result bvArithmeticRightShiftBothWays(vector<FixedBits*>& children, FixedBits& o
 
 	// Now check one-by-one each shifting.
 	// If we are shifting a zero to where a one is (say), then that shifting isn't possible.
+	const int words = output.numberOfWords();
 	for (unsigned shiftIt = minShiftFromShift; shiftIt < numberOfPossibleShifts; shiftIt++)
 	{
 		if (possibleShift[shiftIt])
 		{
-			for (unsigned column = 0; column < bitWidth; column++)
+			for (int w = 0; w < words; w++)
 			{
 				// if they are fixed to different values. That's wrong.
-				if (column + shiftIt <= bitWidth - 1)
+				const Word f = shiftDownWord(op, false, w, shiftIt);
+				const Word v = shiftDownWord(op, true, w, shiftIt);
+				if ((output.getFixedWord(w) & f & (output.getValueWord(w) ^ v)) != 0)
 				{
-					if (output.isFixed(column) && op.isFixed(column + shiftIt)
-							&& (output.getValue(column) != op.getValue(column
-									+ shiftIt)))
-					{
-						possibleShift[shiftIt] = false;
-						break;
-					}
+					possibleShift[shiftIt] = false;
+					break;
 				}
 			}
 		}
 	}
 
 	int nOfPossibleShifts = 0;
+	unsigned biggestShift = 0;
 	for (unsigned i = 0; i < numberOfPossibleShifts; i++)
 	{
 		if (possibleShift[i])
 		{
 			nOfPossibleShifts++;
-			maxShiftFromShift = i;
+			biggestShift = i;
 			if (debug_shift)
 			{
 				std::cerr << "Possible Shift:" << i << std::endl;
@@ -385,23 +430,8 @@ Result bvArithmeticRightShiftBothWays(vector<FixedBits*>& children, FixedBits& o
 	FixedBits setOfPossibleShifts = getPossible(bitWidth, possibleShift, numberOfPossibleShifts,shift);
 
 	// Write in any fixed values to the shift.
-	for (unsigned i = 0; i < bitWidth; i++)
-	{
-		if (setOfPossibleShifts.isFixed(i))
-		{
-			if (!shift.isFixed(i))
-			{
-				shift.setFixed(i, true);
-				shift.setValue(i, setOfPossibleShifts.getValue(i));
-				result = CHANGED;
-			}
-			else if (shift.isFixed(i) && shift.getValue(i)
-					!= setOfPossibleShifts.getValue(i))
-			{
-				return CONFLICT;
-			}
-		}
-	}
+	if (CONFLICT == fixShift(shift, setOfPossibleShifts))
+		return CONFLICT;
 
 	// If a particular input bit appears in every possible shifting,
 	// and if that bit is unfixed,
@@ -409,78 +439,28 @@ Result bvArithmeticRightShiftBothWays(vector<FixedBits*>& children, FixedBits& o
 	// Then, that bit must be fixed.
 	// E.g.  [--] << [0-] == [00]
 
-	bool candidates[bitWidth];
+	// The output columns that each input bit goes to, need to be fixed to the
+	// same value in every possible shifting.
+	Word agreeF[words], agreeV[words];
+	bool first = true;
 	for (unsigned i = 0; i < bitWidth; i++)
-	{
-		candidates[i] = !op.isFixed(i);
-	}
-
-	// candidates: So far: the bits that are unfixed in the operand.
-
-	for (unsigned i = 0; i < numberOfPossibleShifts; i++)
 	{
 		if (possibleShift[i])
 		{
-			// If this shift is possible, then some bits will be shifted out.
-			for (unsigned j = 0; j < i; j++)
-				candidates[j] = false;
+			for (int w = 0; w < words; w++)
+				agree(agreeF[w], agreeV[w], shiftUpWord(output, false, w, i) & output.wordMask(w), shiftUpWord(output, true, w, i), first);
+			first = false;
 		}
 	}
 
-	// candidates: So far: + the input bits that are unfixed.
-	//                     + the input bits that are in every possible fixing.
-
-	// Check all candidates have the same output values.
-	for (unsigned candidate = 0; candidate < bitWidth; candidate++)
-	{
-		bool first = true;
-		bool setTo = false; // value that's never read. To quieten gcc.
-
-		if (candidates[candidate])
-		{
-			for (unsigned shiftIT = 0; shiftIT < bitWidth; shiftIT++)
-			{
-				// If the shift isn't possible continue.
-				if (!possibleShift[shiftIT])
-					continue;
-
-				if (shiftIT > candidate)
-					continue;
-
-				unsigned idx = candidate - shiftIT;
-
-				if (!output.isFixed(idx))
-				{
-					candidates[candidate] = false;
-					break;
-				}
-				else
-				{
-					if (first)
-					{
-						first = false;
-						setTo = output.getValue(idx);
-					}
-					else
-					{
-						if (setTo != output.getValue(idx))
-						{
-							candidates[candidate] = false;
-							break;
-						}
-
-					}
-				}
-			}
-		}
-
-		if (candidates[candidate])
+	// candidates: the input bits that are unfixed, and are in every possible
+	// fixing, i.e. aren't shifted out by the biggest shift.
+	if (!first)
+		for (int w = 0; w < words; w++)
 		{
-			assert(!op.isFixed(candidate));
-			op.setFixed(candidate, true);
-			op.setValue(candidate, setTo);
+			const Word candidates = ~op.getFixedWord(w) & ~FixedBits::prefixMask(w, biggestShift) & agreeF[w];
+			op.fixWord(w, candidates, agreeV[w]);
 		}
-	}
 
 	if (debug_shift)
 		{
@@ -491,69 +471,33 @@ Result bvArithmeticRightShiftBothWays(vector<FixedBits*>& children, FixedBits& o
 
 	// Go through each of the possible shifts. If the same value is fixed
 	// at every location. Then it's fixed too in the result.
-	// Looping over the output columns.
-	bool MSBValue = op.getValue(MSBIndex);
+	// The MSB is shifted in.
+	const Word MSBValue = op.getValue(MSBIndex) ? ~(Word) 0 : 0;
 
-	for (unsigned column = 0; column < bitWidth; column++)
+	first = true;
+	for (unsigned shiftIt = 0; shiftIt < numberOfPossibleShifts; shiftIt++)
+	{
+		if (possibleShift[shiftIt])
 		{
-			bool allFixedToSame = true;
-			bool allFixedTo = false; // value that's never read. To quieten gcc.
-			bool first = true;
-
-			for (unsigned shiftIt = 0; (shiftIt < numberOfPossibleShifts)
-					&& allFixedToSame; shiftIt++)
+			for (int w = 0; w < words; w++)
 			{
-				if (possibleShift[shiftIt])
-				{
-					// Will have shifted in something..
-					if (shiftIt > (bitWidth - 1 -column))
-					{
-						if (first)
-						{
-							allFixedTo = MSBValue;
-							first = false;
-						}
-						else
-						{
-							if (allFixedTo !=  MSBValue)
-							{
-								allFixedToSame = false;
-							}
-						}
-					}
-					else
-					{
-						unsigned index = column + shiftIt;
-						if (!op.isFixed(index))
-							allFixedToSame = false;
-						else if (first && op.isFixed(index))
-						{
-							first = false;
-							allFixedTo = op.getValue(index);
-						}
-						if (op.isFixed(index) && allFixedTo != op.getValue(
-								index))
-							allFixedToSame = false;
-					}
-				}
-			}
-
-			// If it can be just one possible value. Then we can fix 'em.
-			if (allFixedToSame)
-			{
-				if (output.isFixed(column) && (output.getValue(column)
-						!= allFixedTo))
-				{
-							return CONFLICT;
-				}
-				if (!output.isFixed(column))
-				{
-					output.setFixed(column, true);
-					output.setValue(column, allFixedTo);
-					result = CHANGED;
-				}
+				const Word shiftedIn = output.wordMask(w) & ~FixedBits::prefixMask(w, bitWidth - shiftIt);
+				const Word f = shiftDownWord(op, false, w, shiftIt) | shiftedIn;
+				const Word v = (shiftDownWord(op, true, w, shiftIt) & ~shiftedIn) | (MSBValue & shiftedIn);
+				agree(agreeF[w], agreeV[w], f, v, first);
 			}
+			first = false;
 		}
+	}
+
+	for (int w = 0; w < words; w++)
+	{
+		const Result r = fixAgreed(output, w, agreeF[w], agreeV[w]);
+		if (CONFLICT == r)
+			return CONFLICT;
+		if (CHANGED == r)
+			result = CHANGED;
+	}
 	return NOT_IMPLEMENTED;
 }
 
@@ -568,6 +512,8 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 	FixedBits& op = *children[0];
 	FixedBits& shift = *children[1];
 
+	const int words = output.numberOfWords();
+
 	if (debug_shift)
 	{
 		cerr << "op:" << op << endl;
@@ -588,11 +534,11 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 
 	// The shift must be less than the position of the first one in the output
 	int positionOfFirstOne = -1;
-	for (unsigned i = 0; i < bitWidth; i++)
+	for (int w = 0; w < words; w++)
 	{
-		if (output.isFixed(i) && output.getValue(i))
+		if (output.getOnesWord(w) != 0)
 		{
-			positionOfFirstOne = i;
+			positionOfFirstOne = w * wordBits + __builtin_ctzll(output.getOnesWord(w));
 			break;
 		}
 	}
@@ -627,37 +573,36 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 	{
 		if (possibleShift[shiftIt])
 		{
-			for (unsigned column = 0; column < bitWidth; column++)
+			for (int w = 0; w < words; w++)
 			{
-				if (column < shiftIt)
+				// output is one in a column that's shifted in. That's wrong.
+				const Word shiftedIn = FixedBits::prefixMask(w, shiftIt);
+				if ((output.getOnesWord(w) & shiftedIn) != 0)
 				{
-					if (output.isFixed(column) && output.getValue(column)) // output is one in the column. That's wrong.
-					{
-						possibleShift[shiftIt] = false;
-						break;
-					}
+					possibleShift[shiftIt] = false;
+					break;
 				}
-				else
+
+				// if they are fixed to different values. That's wrong.
+				const Word f = shiftUpWord(op, false, w, shiftIt);
+				const Word v = shiftUpWord(op, true, w, shiftIt);
+				if ((output.getFixedWord(w) & f & (output.getValueWord(w) ^ v) & ~shiftedIn) != 0)
 				{
-					// if they are fixed to different values. That's wrong.
-					if (output.isFixed(column) && op.isFixed(column - shiftIt) && (output.getValue(column) != op.getValue(column - shiftIt)))
-					{
-						possibleShift[shiftIt] = false;
-						break;
-					}
+					possibleShift[shiftIt] = false;
+					break;
 				}
 			}
 		}
 	}
 
 	int nOfPossibleShifts = 0;
-	int shiftIndex = 0;
+	unsigned biggestShift = 0;
 	for (unsigned i = 0; i < numberOfPossibleShifts; i++)
 	{
 		if (possibleShift[i])
 		{
 			nOfPossibleShifts++;
-			shiftIndex = i;
+			biggestShift = i;
 			if (debug_shift)
 			{
 				std::cerr << "Possible:" << i << std::endl;
@@ -676,97 +621,15 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 
 	// We have a list of all the possible shift amounts.
 	// We take the union of all the bits that are possible.
-
-	FixedBits v(bitWidth, false);
-	bool first = true;
-	for (unsigned i = 0; i < numberOfPossibleShifts-1; i++)
-	{
-		if (possibleShift[i])
-		{
-			if (first)
-			{
-				first = false;
-				for (unsigned j = 0; j < (unsigned) v.getWidth(); j++)
-				{
-					v.setFixed(j, true);
-					if (j <  sizeof(unsigned)*8)
-						v.setValue(j, 0 != (i & (1 << j)));
-					else
-						v.setValue(j, false);
-				}
-			}
-			else
-			{
-				// join.
-				for (unsigned j = 0; j < (unsigned) v.getWidth() && j <  sizeof(unsigned)*8; j++)
-				{
-					if (v.isFixed(j))
-					{
-						// union.
-						if (v.getValue(j) != (0!=(i & (1 << j))))
-							v.setFixed(j, false);
-					}
-				}
-			}
-		}
-	}
-
-	// The top most entry of the shift table is special. It means all values of shift
-	// that fill it completely with zeroes. We take the union of all of the values >bitWidth
-	// in this function.
-	if (possibleShift[numberOfPossibleShifts - 1])
-	{
-		FixedBits bitWidthFB = FixedBits::fromUnsignedInt(bitWidth, bitWidth);
-		FixedBits output(1, true);
-		output.setFixed(0, true);
-		output.setValue(0, true);
-		FixedBits working(shift);
-
-		vector<FixedBits*> args;
-		args.push_back(&working);
-		args.push_back(&bitWidthFB);
-
-		//Write into working anything that can be determined given it's >=bitWidth.
-		Result r = bvGreaterThanEqualsBothWays(args,output);
-		assert(CONFLICT != r);
-
-		// Get the union of "working" with the prior union.
-		for (unsigned i = 0; i < bitWidth; i++)
-		{
-			if (!working.isFixed(i) && v.isFixed(i))
-				v.setFixed(i, false);
-			if (working.isFixed(i) && v.isFixed(i) && (working.getValue(i) != v.getValue(i)))
-				v.setFixed(i, false);
-			if (first) // no less shifts possible.
-			{
-				if (working.isFixed(i))
-				{
-					v.setFixed(i, true);
-					v.setValue(i, working.getValue(i));
-				}
-			}
-		}
-	}
+	FixedBits v = getPossible(bitWidth, possibleShift, numberOfPossibleShifts, shift);
 
 	if (debug_shift)
 	{
 		std::cerr << "Shift Amount:" << v << std::endl;
 	}
 
-	for (unsigned i = 0; i < bitWidth; i++)
-	{
-		if (v.isFixed(i))
-		{
-			if (!shift.isFixed(i))
-			{
-				shift.setFixed(i, true);
-				shift.setValue(i, v.getValue(i));
-				result = CHANGED;
-			}
-			else if (shift.isFixed(i) && shift.getValue(i) != v.getValue(i))
-				return CONFLICT;
-		}
-	}
+	if (CONFLICT == fixShift(shift, v))
+		return CONFLICT;
 
 	// If a particular input bit appears in every possible shifting,
 	// and if that bit is unfixed,
@@ -774,151 +637,55 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 	// Then, that bit must be fixed.
 	// E.g.  [--] << [0-] == [00]
 
-	bool candidates[bitWidth];
+	// The output columns that each input bit goes to, need to be fixed to the
+	// same value in every possible shifting.
+	Word agreeF[words], agreeV[words];
+	bool first = true;
 	for (unsigned i = 0; i < bitWidth; i++)
-	{
-		candidates[i] = !op.isFixed(i);
-	}
-
-	// candidates: So far: the bits that are unfixed.
-
-	for (unsigned i = 0; i < numberOfPossibleShifts; i++)
 	{
 		if (possibleShift[i])
 		{
-			// If this shift is possible, then some bits will be shifted out.
-			for (unsigned j = 0; j < i; j++)
-				candidates[bitWidth - 1 - j] = false;
+			for (int w = 0; w < words; w++)
+				agree(agreeF[w], agreeV[w], shiftDownWord(output, false, w, i), shiftDownWord(output, true, w, i), first);
+			first = false;
 		}
 	}
 
-	// candidates: So far: + the input bits that are unfixed.
-	//                     + the input bits that are in every possible fixing.
-
-	// Check all candidates have the same output values.
-	for (unsigned candidate = 0; candidate < bitWidth; candidate++)
-	{
-		bool first = true;
-		bool setTo = false; // value that's never read. To quieten gcc.
-
-		if (candidates[candidate])
+	// candidates: the input bits that are unfixed, and are in every possible
+	// fixing, i.e. aren't shifted out by the biggest shift.
+	if (!first)
+		for (int w = 0; w < words; w++)
 		{
-			for (unsigned shiftIT = 0; shiftIT < bitWidth; shiftIT++)
-			{
-				// If the shift isn't possible continue.
-				if (!possibleShift[shiftIT])
-					continue;
-
-				unsigned idx = candidate + shiftIT;
-
-				if (!output.isFixed(idx))
-				{
-					candidates[candidate] = false;
-					break;
-				}
-				else
-				{
-					if (first)
-					{
-						first = false;
-						setTo = output.getValue(idx);
-					}
-					else
-					{
-						if (setTo != output.getValue(idx))
-						{
-							candidates[candidate] = false;
-							break;
-						}
-
-					}
-				}
-			}
-		}
-
-		if (candidates[candidate])
-		{
-			assert(!op.isFixed(candidate));
-			op.setFixed(candidate, true);
-			op.setValue(candidate, setTo);
+			const Word candidates = ~op.getFixedWord(w) & FixedBits::prefixMask(w, bitWidth - biggestShift) & agreeF[w];
+			op.fixWord(w, candidates, agreeV[w]);
 		}
-	}
-
-	// done.
 
 	// Go through each of the possible shifts. If the same value is fixed
 	// at every location. Then it's fixed too in the result.
-	for (unsigned column = 0; column < bitWidth; column++)
+	first = true;
+	for (unsigned shiftIt = 0; shiftIt < numberOfPossibleShifts; shiftIt++)
 	{
-		bool allFixedToSame = true;
-		bool allFixedTo = false; // value that's never read. To quieten gcc.
-		bool first = true;
-
-		for (unsigned shiftIt = minShift; (shiftIt < numberOfPossibleShifts) && allFixedToSame; shiftIt++)
-		{
-			if (possibleShift[shiftIt])
-			{
-				// Will have shifted in zeroes.
-				if (shiftIt > column)
-				{
-					if (first)
-					{
-						allFixedTo = false;
-						first = false;
-					}
-					else
-					{
-						if (allFixedTo)
-						{
-							allFixedToSame = false;
-						}
-					}
-				}
-				else
-				{
-					unsigned index = column - shiftIt;
-					if (!op.isFixed(index))
-						allFixedToSame = false;
-					else if (first && op.isFixed(index))
-					{
-						first = false;
-						allFixedTo = op.getValue(index);
-					}
-					if (op.isFixed(index) && allFixedTo != op.getValue(index))
-						allFixedToSame = false;
-				}
-			}
-		}
-
-		// If it can be just one possible value. Then we can fix 'em.
-		if (allFixedToSame)
+		if (possibleShift[shiftIt])
 		{
-			if (output.isFixed(column) && (output.getValue(column) != allFixedTo))
-				return CONFLICT;
-			if (!output.isFixed(column))
+			// Will have shifted in zeroes.
+			for (int w = 0; w < words; w++)
 			{
-				output.setFixed(column, true);
-				output.setValue(column, allFixedTo);
-				result = CHANGED;
+				const Word shiftedIn = FixedBits::prefixMask(w, shiftIt) & output.wordMask(w);
+				const Word f = (shiftUpWord(op, false, w, shiftIt) | shiftedIn) & output.wordMask(w);
+				agree(agreeF[w], agreeV[w], f, shiftUpWord(op, true, w, shiftIt) & ~shiftedIn, first);
 			}
+			first = false;
 		}
 	}
 
-	/*
-	// If there is only one possible shift value. Then, we can push from the output back.
-	if (1 == nOfPossibleShifts)
+	for (int w = 0; w < words; w++)
 	{
-		for (unsigned i = shiftIndex; i < bitWidth; i++)
-		{
-			if (!op.isFixed(i - shiftIndex) && output.isFixed(i))
-			{
-				op.setFixed(i - shiftIndex, true);
-				op.setValue(i - shiftIndex, output.getValue(i));
-				result = CHANGED;
-			}
-		}
+		const Result r = fixAgreed(output, w, agreeF[w], agreeV[w]);
+		if (CONFLICT == r)
+			return CONFLICT;
+		if (CHANGED == r)
+			result = CHANGED;
 	}
-*/
 
 	return NOT_IMPLEMENTED;
 }
@@ -24,33 +24,28 @@ Result bvEqualsBothWays(FixedBits& a, FixedBits& b, FixedBits& output)
 	assert(a.getWidth() == b.getWidth());
 	assert(1 == output.getWidth());
 
-	const int childWidth = a.getWidth();
+	typedef FixedBits::Word Word;
+	const int words = a.numberOfWords();
 
 	Result r = NO_CHANGE;
 
-	bool allSame = true;
+	// Columns where both are fixed to different values, and how many bits are unfixed.
 	bool definatelyFalse = false;
+	int unknown = 0;
 
-	for (int i = 0; i < childWidth; i++)
+	for (int w = 0; w < words; w++)
 	{
-		// if both fixed
-		if (a.isFixed(i) && b.isFixed(i))
+		const Word aF = a.getFixedWord(w), bF = b.getFixedWord(w);
+		if ((aF & bF & (a.getValueWord(w) ^ b.getValueWord(w))) != 0)
 		{
-			// And have different values.
-			if (a.getValue(i) != b.getValue(i))
-			{
-				definatelyFalse = true;
-				break;
-			}
-			else
-			{
-				allSame &= true;
-				continue;
-			}
+			definatelyFalse = true;
+			break;
 		}
-		allSame &= false;
+		unknown += __builtin_popcountll(~aF & a.wordMask(w)) + __builtin_popcountll(~bF & b.wordMask(w));
 	}
 
+	const bool allSame = !definatelyFalse && unknown == 0;
+
 	if (definatelyFalse)
 	{
 		if (output.isFixed(0) && output.getValue(0))
@@ -80,69 +75,23 @@ Result bvEqualsBothWays(FixedBits& a, FixedBits& b, FixedBits& output)
 
 	if (output.isFixed(0) && output.getValue(0)) // all should be the same.
 	{
-		for (int i = 0; i < childWidth; i++)
-		{
-			if (a.isFixed(i) && b.isFixed(i))
-			{
-				if (a.getValue(i) != b.getValue(i))
-				{
-					return CONFLICT;
-				}
-			}
-			else if (a.isFixed(i) != b.isFixed(i)) // both same but only one is fixed.
-			{
-				if (a.isFixed(i))
-				{
-					b.setFixed(i, true);
-					b.setValue(i, a.getValue(i));
-					r = CHANGED;
-				}
-				else
-				{
-					a.setFixed(i, true);
-					a.setValue(i, b.getValue(i));
-					r = CHANGED;
-				}
-			}
-		}
+		Result result = makeEqual(a, b, 0, a.getWidth());
+		if (CONFLICT == result)
+			return CONFLICT;
+		if (CHANGED == result)
+			r = CHANGED;
 	}
 
 	// if the result is fixed to false, there is a single unspecied value, and all the rest are the same. Fix it to the opposite.
-	if (output.isFixed(0) && !output.getValue(0))
+	if (output.isFixed(0) && !output.getValue(0) && !definatelyFalse && 1 == unknown)
 	{
-		int unknown = 0;
-
-		for (int i = 0; i < childWidth && unknown < 2; i++)
+		for (int w = 0; w < words; w++)
 		{
-			if (!a.isFixed(i))
-				unknown++;
-			if (!b.isFixed(i))
-				unknown++;
-			else if (a.isFixed(i) && b.isFixed(i) && a.getValue(i) != b.getValue(i))
-			{
-				unknown = 10; // hack, don't do the next loop.
-				break;
-			}
-		}
-
-		if (1 == unknown)
-		{
-			for (int i = 0; i < childWidth; i++)
-			{
-				if (!a.isFixed(i))
-				{
-					a.setFixed(i, true);
-					a.setValue(i, !b.getValue(i));
-					r = CHANGED;
-				}
-				if (!b.isFixed(i))
-				{
-					b.setFixed(i, true);
-					b.setValue(i, !a.getValue(i));
-					r = CHANGED;
-				}
-			}
+			const Word aF = a.getFixedWord(w), bF = b.getFixedWord(w);
+			a.fixWord(w, ~aF & a.wordMask(w), ~b.getValueWord(w));
+			b.fixWord(w, ~bF & b.wordMask(w), ~a.getValueWord(w));
 		}
+		r = CHANGED;
 	}
 	return r;
 }
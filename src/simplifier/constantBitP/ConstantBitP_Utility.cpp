@@ -52,6 +52,45 @@ stats getStats(const vector<FixedBits*>& operands, const unsigned position)
 	return result;
 }
 
+wordStats getWordStats(const vector<FixedBits*>& operands, const int w)
+{
+	typedef FixedBits::Word Word;
+	wordStats result = { 0, 0, 0, ~(Word) 0, 0 };
+	Word moreUnfixed = 0;
+
+	for (unsigned i = 0, size = operands.size(); i < size; i++)
+	{
+		const Word unfixed = ~operands[i]->getFixedWord(w);
+		const Word ones = operands[i]->getOnesWord(w);
+
+		result.someZero |= operands[i]->getZeroesWord(w);
+		result.someOne |= ones;
+		result.oddOnes ^= ones;
+
+		moreUnfixed |= result.oneUnfixed & unfixed;
+		result.oneUnfixed = (result.oneUnfixed & ~unfixed) | (result.noneUnfixed & unfixed);
+		result.noneUnfixed &= ~unfixed;
+	}
+
+	assert((result.oneUnfixed & moreUnfixed) == 0);
+	return result;
+}
+
+bool fixUnfixedWordTo(vector<FixedBits*>& operands, const int w, const FixedBits::Word mask, bool toFix)
+{
+	bool changed = false;
+	for (unsigned i = 0; i < operands.size(); i++)
+	{
+		const FixedBits::Word unfixed = mask & ~operands[i]->getFixedWord(w);
+		if (unfixed != 0)
+		{
+			operands[i]->fixWord(w, unfixed, toFix ? ~(FixedBits::Word) 0 : 0);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
 Result makeEqual(FixedBits& a, FixedBits& b, int from, int to)
 {
 	assert(to >= from);
@@ -59,93 +98,58 @@ Result makeEqual(FixedBits& a, FixedBits& b, int from, int to)
 	assert(from <= a.getWidth());
 	assert(from <= b.getWidth());
 
+	typedef FixedBits::Word Word;
+
 	Result result = NO_CHANGE;
-	for (int i = from; i < to; i++)
+	for (int w = from / FixedBits::wordBits; w * FixedBits::wordBits < to; w++)
 	{
-		if (a.isFixed(i) && !b.isFixed(i))
-		{
-			b.setFixed(i, true);
-			b.setValue(i, a.getValue(i));
-			result = CHANGED;
-		}
-		else if (b.isFixed(i) && !a.isFixed(i))
+		const Word m = FixedBits::prefixMask(w, to) & ~FixedBits::prefixMask(w, from);
+		const Word aF = a.getFixedWord(w), bF = b.getFixedWord(w);
+
+		if ((aF & bF & (a.getValueWord(w) ^ b.getValueWord(w)) & m) != 0)
+			return CONFLICT;
+
+		if (((aF ^ bF) & m) != 0)
 		{
-			a.setFixed(i, true);
-			a.setValue(i, b.getValue(i));
+			b.fixWord(w, aF & ~bF & m, a.getValueWord(w));
+			a.fixWord(w, bF & ~aF & m, b.getValueWord(w));
 			result = CHANGED;
 		}
-		else if (b.isFixed(i) && a.isFixed(i))
-		{
-			if (a.getValue(i) != b.getValue(i))
-				return CONFLICT;
-		}
 	}
 	return result;
 }
 
+// Writes word "w" of a FixedBits sized value into the bitvector.
+static void setCBVWord(CBV r, const int w, const FixedBits::Word value)
+{
+	const unsigned cbvBits = sizeof(*r) * 8;
+	const unsigned perWord = FixedBits::wordBits / cbvBits;
+	for (unsigned j = 0; j < perWord && w * perWord + j < size_(r); j++)
+		r[w * perWord + j] = (unsigned) (value >> (j * cbvBits));
+}
+
 void setSignedMinMax(FixedBits& v, CBV min, CBV max)
 {
 	const unsigned int msb = v.getWidth() - 1;
 
-	for (unsigned i = 0; i < (unsigned) v.getWidth(); i++)
-	{
-		if (v.isFixed(i))
-		{
-			if (v.getValue(i)) // if it's on. It's on.
+	// Not fixed. Make the maximum Maximum.
+	setUnsignedMinMax(v, min, max);
 
-			{
-				CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_On(min, i);
-			}
-			else
-			{
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-				CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-		}
-		else
-		{
-			if (i != msb)
-			{ // not fixed. Make the maximum Maximum.
-				CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-			else
-			{ //except for the msb. Where we reduce the min.
-				CONSTANTBV::BitVector_Bit_On(min, i);
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-			}
-		}
+	if (!v.isFixed(msb))
+	{ //except for the msb. Where we reduce the min.
+		CONSTANTBV::BitVector_Bit_On(min, msb);
+		CONSTANTBV::BitVector_Bit_Off(max, msb);
 	}
 	assert(CONSTANTBV::BitVector_Compare(min,max) <=0);
 }
 
 void setUnsignedMinMax(const FixedBits& v, CBV min, CBV max)
 {
-	CONSTANTBV::BitVector_Fill(max);
-	CONSTANTBV::BitVector_Empty(min);
-
-	for (int i = 0; i < v.getWidth(); i++)
+	// The fixed ones are on in both. The unfixed bits are only on in the max.
+	for (int w = 0; w < v.numberOfWords(); w++)
 	{
-		if (v.isFixed(i))
-		{
-			if (v.getValue(i)) // if it's on. It's on.
-
-			{
-				//CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_On(min, i);
-			}
-			else
-			{
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-				//CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-		}
-		//else // not fixed. Just set the max.
-		//{
-		//	CONSTANTBV::BitVector_Bit_On(max, i);
-		//	CONSTANTBV::BitVector_Bit_Off(min, i);
-		//}
+		setCBVWord(min, w, v.getOnesWord(w));
+		setCBVWord(max, w, ~v.getZeroesWord(w) & v.wordMask(w));
 	}
 	assert(CONSTANTBV::BitVector_Lexicompare(min,max) <=0);
 }
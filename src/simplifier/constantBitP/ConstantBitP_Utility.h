@@ -36,6 +36,22 @@ struct stats
 Result merge(Result r1, Result r2);
 
 stats getStats(const vector<FixedBits*>& operands, const unsigned position);
+
+// The same as stats, but for all the columns of a word at once. Each is a mask
+// of the columns where it's true.
+struct wordStats
+{
+	FixedBits::Word someZero; // at least one operand is fixed to zero.
+	FixedBits::Word someOne; // at least one operand is fixed to one.
+	FixedBits::Word oddOnes; // an odd number are fixed to one.
+	FixedBits::Word noneUnfixed;
+	FixedBits::Word oneUnfixed; // exactly one is unfixed.
+};
+
+wordStats getWordStats(const vector<FixedBits*>& operands, const int w);
+
+// Fix the unfixed values in word "w" of the operands, in the columns of the mask.
+bool fixUnfixedWordTo(vector<FixedBits*>& operands, const int w, const FixedBits::Word mask, bool toFix);
 }
 }
 
@@ -154,7 +154,8 @@ namespace simplifier
       status = NO_CHANGE;
       simplifier = _sm;
       nf = _nf;
-      fixedMap = new NodeToFixedBitsMap(1000); // better to use the function that returns the number of nodes.. whatever that is.
+      formula = top;
+      fixedMap = new NodeToFixedBitsMap();
       workList = new WorkList(top);
       dependents = new Dependencies(top); // List of the parents of a node.
       msm = new MultiplicationStatsMap();
@@ -196,6 +197,82 @@ namespace simplifier
       topFixed = false;
     }
 
+    ConstantBitPropagation::ConstantBitPropagation(const ConstantBitPropagation& other)
+    {
+      status = other.status;
+      simplifier = other.simplifier;
+      nf = other.nf;
+      formula = other.formula;
+      topFixed = other.topFixed;
+
+      fixedMap = new NodeToFixedBitsMap();
+      NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it;
+      for (it = other.fixedMap->map->begin(); it != other.fixedMap->map->end(); it++)
+        fixedMap->map->insert(make_pair(it->first, new FixedBits(*it->second)));
+
+      workList = new WorkList();
+      dependents = new Dependencies(formula);
+      msm = new MultiplicationStatsMap(*other.msm);
+    }
+
+    void
+    ConstantBitPropagation::update(const ASTNode& top)
+    {
+      assert (BOOLEAN_TYPE == top.GetType());
+      topFixed = false;
+
+      if (top == formula || CONFLICT == status)
+        {
+          formula = top;
+          return;
+        }
+
+      ASTVec added;
+      dependents->build(top, top, &added);
+
+      ASTVec removed;
+      dependents->remove(formula, top, removed);
+      formula = top;
+
+      if (removed.size() > 0)
+        {
+          ASTNodeSet gone(removed.begin(), removed.end());
+          NodeToFixedBitsMap* kept = new NodeToFixedBitsMap();
+
+          // Constants are dropped too, they are made again when they're needed.
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::iterator it;
+          for (it = fixedMap->map->begin(); it != fixedMap->map->end(); it++)
+            if (!it->first.isConstant() && gone.find(it->first) == gone.end())
+              {
+                kept->map->insert(*it);
+                it->second = NULL;
+              }
+          delete fixedMap;
+          fixedMap = kept;
+
+          for (unsigned i = 0; i < removed.size(); i++)
+            msm->map.erase(removed[i]);
+        }
+
+      // Like the initial worklist, the new nodes are scheduled if they have
+      // a child with something fixed.
+      for (unsigned i = 0; i < added.size(); i++)
+        {
+          const ASTNode& n = added[i];
+          for (unsigned j = 0; j < n.GetChildren().size(); j++)
+            {
+              NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it = fixedMap->map->find(n[j]);
+              if (n[j].isConstant() || (it != fixedMap->map->end() && it->second->countFixed() > 0))
+                {
+                  workList->push(n);
+                  break;
+                }
+            }
+        }
+
+      propagate();
+    }
+
     // Both way propagation. Initialising the top to "true".
     // The hardest thing to understand is the two cases:
     // 1) If we get the fixed bits of a node, without assuming the top node is true,
@@ -213,7 +290,12 @@ namespace simplifier
       status = NO_CHANGE;
 
       //Determine what must always be true.
-      ASTNodeMap fromTo = getAllFixed();
+      return topLevelBothWays(top, getAllFixed(), setTopToTrue, conjoinToTop);
+    }
+
+    ASTNode
+    ConstantBitPropagation::topLevelBothWays(const ASTNode& top, ASTNodeMap fromTo, bool setTopToTrue, bool conjoinToTop)
+    {
       {
         ASTNodeMap::iterator it = fromTo.begin();
         while(it != fromTo.end())
@@ -403,6 +485,48 @@ namespace simplifier
       return result;
     }
 
+    ConstantBitPropagationIncremental::ConstantBitPropagationIncremental(Simplifier* _sm, NodeFactory* _nf,
+        bool _incremental)
+    {
+      simplifier = _sm;
+      nf = _nf;
+      incremental = _incremental;
+      bottomUp = NULL;
+      topDown = NULL;
+    }
+
+    ConstantBitPropagation*
+    ConstantBitPropagationIncremental::getBottomUp(const ASTNode& top)
+    {
+      if (!incremental)
+        clear();
+
+      if (bottomUp == NULL)
+        bottomUp = new ConstantBitPropagation(simplifier, nf, top);
+      else
+        bottomUp->update(top);
+
+      return bottomUp;
+    }
+
+    ASTNode
+    ConstantBitPropagationIncremental::topLevelBothWays(const ASTNode& top, bool conjoinToTop)
+    {
+      // Setting a constant to true would stay in the fixings.
+      if (top.isConstant())
+        return top;
+
+      getBottomUp(top);
+
+      // Starting from the bottom up fixings is what ConstantBitPropagation does.
+      if (topDown == NULL)
+        topDown = new ConstantBitPropagation(*bottomUp);
+      else
+        topDown->update(top);
+
+      return topDown->topLevelBothWays(top, bottomUp->getAllFixed(), true, conjoinToTop);
+    }
+
     void
     notHandled(const Kind& k)
     {
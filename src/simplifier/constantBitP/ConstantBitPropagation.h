@@ -41,6 +41,9 @@ namespace simplifier
 
       bool topFixed;
 
+      // The node it was made with, or last updated to.
+      ASTNode formula;
+
       // A vector that's reused.
       vector< int > previousChildrenFixedCount;
 
@@ -68,6 +71,9 @@ public:
       // propagates.
       ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf, const ASTNode & top);
 
+      // Starts with a copy of the fixings of "other". Nothing is scheduled.
+      ConstantBitPropagation(const ConstantBitPropagation& other);
+
       ~ConstantBitPropagation()
       {
         clearTables();
@@ -78,6 +84,17 @@ public:
       BEEV::ASTNode
       topLevelBothWays(const ASTNode& top, bool setTopToTrue = true, bool conjoinToTop=true);
 
+      // The same, but "fromTo" holds the nodes that are totally fixed without
+      // assuming anything.
+      BEEV::ASTNode
+      topLevelBothWays(const ASTNode& top, ASTNodeMap fromTo, bool setTopToTrue, bool conjoinToTop);
+
+      // Moves on to "top", which replaces the node it was made with, or last
+      // updated to. The fixings of the nodes that are in both are kept, the
+      // others are dropped, and it propagates from the nodes that are new.
+      void
+      update(const ASTNode& top);
+
 
       void clearTables()
       {
@@ -115,6 +132,78 @@ public:
       }
 
     };
+
+    // Propagates through the versions of a formula that the simplifications
+    // produce one after the other, e.g. each time sizeReducing is called. The
+    // fixings of the nodes that are in consecutive versions are kept, so only
+    // what is new is propagated from. That relies on each model of a version
+    // giving a model of the versions before, without changing the values of
+    // the variables that are in it, which the substitutions keep.
+    class ConstantBitPropagationIncremental
+    {
+      Simplifier *simplifier;
+      NodeFactory *nf;
+
+      // If false, each version is propagated from scratch.
+      bool incremental;
+
+      // Nothing is assumed, so its fixings hold for every assignment.
+      ConstantBitPropagation *bottomUp;
+
+      // Assumes each version is true.
+      ConstantBitPropagation *topDown;
+
+      ConstantBitPropagationIncremental(const ConstantBitPropagationIncremental&);
+      ConstantBitPropagationIncremental&
+      operator=(const ConstantBitPropagationIncremental&);
+
+      ConstantBitPropagation*
+      getBottomUp(const ASTNode& top);
+
+    public:
+      ConstantBitPropagationIncremental(Simplifier* _sm, NodeFactory* _nf, bool _incremental);
+
+      ~ConstantBitPropagationIncremental()
+      {
+        clear();
+      }
+
+      // The same as ConstantBitPropagation::topLevelBothWays() with the top set to true.
+      BEEV::ASTNode
+      topLevelBothWays(const ASTNode& top, bool conjoinToTop = true);
+
+      bool
+      isUnsatisfiable()
+      {
+        return topDown != NULL && topDown->isUnsatisfiable();
+      }
+
+      // Propagation that doesn't assume "top", for the bit-blaster. The
+      // caller takes it over.
+      ConstantBitPropagation*
+      releaseBottomUp(const ASTNode& top)
+      {
+        ConstantBitPropagation* result = getBottomUp(top);
+        bottomUp = NULL;
+        return result;
+      }
+
+      // Frees the fixings that assume the formula is true.
+      void
+      clearTopDown()
+      {
+        delete topDown;
+        topDown = NULL;
+      }
+
+      void
+      clear()
+      {
+        clearTopDown();
+        delete bottomUp;
+        bottomUp = NULL;
+      }
+    };
   }
 }
 
@@ -22,8 +22,9 @@ namespace simplifier
 
     public:
       // All the nodes that depend on the value of a particular node.
+      // The nodes that weren't already there are added to "added".
       void
-      build(const ASTNode & current, const ASTNode & prior)
+      build(const ASTNode & current, const ASTNode & prior, ASTVec* added = NULL)
       {
         if (current.isConstant()) // don't care about what depends on constants.
           return;
@@ -36,6 +37,8 @@ namespace simplifier
             vec = new set<ASTNode> ();
 
             dependents.insert(std::pair<ASTNode, set<ASTNode>*>(current, vec));
+            if (added != NULL)
+              added->push_back(current);
           }
         else
           {
@@ -52,7 +55,36 @@ namespace simplifier
 
         for (unsigned int i = 0; i < current.GetChildren().size(); i++)
           {
-            build(current.GetChildren()[i], current);
+            build(current.GetChildren()[i], current, added);
+          }
+      }
+
+      // "n" has been replaced by "top". Removes "n" if nothing depends on it
+      // any more, and then whatever was only there because of it. The nodes
+      // removed are added to "removed". Call build() on "top" first.
+      void
+      remove(const ASTNode& n, const ASTNode& top, ASTVec& removed)
+      {
+        if (n == top)
+          return;
+
+        NodeToDependentNodeMap::iterator it = dependents.find(n);
+        if (it == dependents.end() || !it->second->empty())
+          return;
+
+        delete it->second;
+        dependents.erase(it);
+        removed.push_back(n);
+
+        for (unsigned i = 0; i < n.GetChildren().size(); i++)
+          {
+            const ASTNode& child = n.GetChildren()[i];
+            NodeToDependentNodeMap::iterator c = dependents.find(child);
+            if (c == dependents.end())
+              continue;
+
+            c->second->erase(n);
+            remove(child, top, removed);
           }
       }
 
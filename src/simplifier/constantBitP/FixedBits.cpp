@@ -5,9 +5,9 @@
 
 #include "ConstantBitP_Utility.h"
 
-// To reduce the memory I tried using the constantbv stuff. But because it is not
-// inlined it took about twice as long per propagation as does using a boolean array.
-// Other options to reduce memory usage are: vector<bool>, dynamic_bitset, or bitMagic.
+// The bits used to be stored in two bool arrays. Packing them into words makes
+// the FixedBits an eighth of the size, and lets the transfer functions, and the
+// functions here, work on 64 columns at once.
 
 
 namespace simplifier
@@ -35,10 +35,10 @@ namespace simplifier
     void
     FixedBits::fixToZero()
     {
-      for (int i = 0; i < getWidth(); i++)
+      for (int w = 0; w < numberOfWords(); w++)
         {
-          setFixed(i, true);
-          setValue(i, false);
+          fixed[w] = wordMask(w);
+          values[w] = 0;
         }
     }
 
@@ -49,11 +49,10 @@ namespace simplifier
 
       BEEV::CBV result = CONSTANTBV::BitVector_Create(width, true);
 
-      for (int i = 0; i < width; i++)
-        {
-          if (values[i])
-            CONSTANTBV::BitVector_Bit_On(result, i);
-        }
+      // The bits past the width are zero, so whole words can be copied.
+      const unsigned cbvBits = sizeof(*result) * 8;
+      for (unsigned j = 0; j < size_(result); j++)
+        result[j] = (unsigned) (values[j * cbvBits / wordBits] >> ((j * cbvBits) % wordBits));
 
       return result;
     }
@@ -77,24 +76,41 @@ namespace simplifier
       return result;
     }
 
+    // Sets the width, and points "fixed" and "values" at storage for it.
+    // The storage isn't initialised.
+    void
+    FixedBits::allocate(int n)
+    {
+      width = n;
+      const int words = numberOfWords();
+      if (words <= inlineWords)
+        {
+          fixed = inlineStore;
+          values = inlineStore + inlineWords;
+        }
+      else
+        {
+          fixed = new Word[2 * words];
+          values = fixed + words;
+        }
+    }
+
     void
     FixedBits::init(const FixedBits& copy)
     {
-      width = copy.width;
-      fixed = new bool[width];
-      values = new bool[width];
+      allocate(copy.width);
       representsBoolean = copy.representsBoolean;
 
-      memcpy(fixed, copy.fixed, width * sizeof(bool));
-      memcpy(values, copy.values, width * sizeof(bool));
+      memcpy(fixed, copy.fixed, numberOfWords() * sizeof(Word));
+      memcpy(values, copy.values, numberOfWords() * sizeof(Word));
     }
 
     bool
     FixedBits::isTotallyFixed() const
     {
-      for (int i = 0; i < width; i++)
+      for (int w = 0; w < numberOfWords(); w++)
         {
-          if (!fixed[i])
+          if (fixed[w] != wordMask(w))
             return false;
         }
 
@@ -105,14 +121,12 @@ namespace simplifier
     {
       assert(n > 0);
 
-      fixed = new bool[n];
-      values = new bool[n];
-      width = n;
+      allocate(n);
 
-      for (int i = 0; i < width; i++)
+      for (int w = 0; w < numberOfWords(); w++)
         {
-          fixed[i] = false; // I don't know if there's a default value??
-          values[i] = false; // stops it printing out junk.
+          fixed[w] = 0;
+          values[w] = 0; // stops it printing out junk.
         }
 
       representsBoolean = isbool;
@@ -132,23 +146,10 @@ namespace simplifier
 
       FixedBits result(a.getWidth(), a.isBoolean());
 
-      for (int i = 0; i < a.getWidth(); i++)
-        {
-          if (a.isFixed(i) != b.isFixed(i))
-            {
-              result.setFixed(i, false);
-            }
-          else if (a.isFixed(i) && b.isFixed(i) && (a.getValue(i)
-              != b.getValue(i)))
-            {
-              result.setFixed(i, false);
-            }
-          else if (a.isFixed(i) && b.isFixed(i))
-            { // fixed to the same value.
-              result.setFixed(i, true);
-              result.setValue(i, a.getValue(i));
-            }
-        }
+      // Fixed in both to the same value.
+      for (int w = 0; w < a.numberOfWords(); w++)
+        result.fixWord(w, a.fixed[w] & b.fixed[w] & ~(a.values[w] ^ b.values[w]), a.values[w]);
+
       return result;
     }
 
@@ -160,35 +161,18 @@ namespace simplifier
       assert(a.getWidth() == getWidth());
       assert(a.isBoolean() == isBoolean());
 
-      for (int i = 0; i < a.getWidth(); i++)
-        {
-          if (a.isFixed(i) && isFixed(i) && (a.getValue(i) == getValue(i)))
-            {
-              // nothind.
-            }
-          else
-            {
-              setFixed(i,false);
-            }
-        }
+      // Stays fixed only if "a" has it fixed to the same value.
+      for (int w = 0; w < numberOfWords(); w++)
+        fixed[w] &= a.fixed[w] & ~(a.values[w] ^ values[w]);
     }
 
     void
     FixedBits::join(unsigned int a)
     {
-      for (int i = 0; i < getWidth(); i++)
+      for (int w = 0; w < numberOfWords(); w++)
         {
-          if (isFixed(i))
-            {
-                if (
-                    (((a >> i) & 1) ==1)
-                  &&
-                    !getValue(i)
-                   )
-                  setFixed(i,false);
-                else if ((((a >> i) & 1) ==0) && getValue(i))
-                  setFixed(i,false);
-            }
+          const Word aw = (w == 0) ? a : 0;
+          fixed[w] &= ~(aw ^ values[w]);
         }
     }
 
@@ -204,24 +188,15 @@ namespace simplifier
     bool
     FixedBits::unsignedHolds_new(unsigned val)
     {
-      const int initial_width = std::min((int)width, (int)sizeof(unsigned) * 8);
-
-      for (int i = 0; i < initial_width; i++)
-        {
-          char v = (*this)[i];
-          if ('*'== v)
-            {} // ok
-          else if ((v == '1') != ((val & 1) != 0))
-            return false;
-          val = val >> 1;
-        }
-
       // If the unsigned representation is bigger, false if not zero.
-      if ((int) sizeof(unsigned) * 8 > width && (val !=0))
-         return false;
+      if (width < wordBits && (((Word) val) & ~wordMask(0)) != 0)
+        return false;
+
+      if ((fixed[0] & (values[0] ^ val)) != 0)
+        return false;
 
-      for (int i = (int) sizeof(unsigned) * 8; i < width; i++)
-        if (isFixed(i) && getValue(i))
+      for (int w = 1; w < numberOfWords(); w++)
+        if (getOnesWord(w) != 0)
           return false;
 
       return true;
@@ -321,13 +296,17 @@ namespace simplifier
 
       if (BEEV::BITVECTOR_TYPE == n.GetType())
         {
-          // loop through testing each of the bits.
+          // Copy in the words of the constant.
           BEEV::CBV cbv = n.GetBVConst();
+          const unsigned cbvBits = sizeof(*cbv) * 8;
 
-          for (int j = 0; j < bitWidth; j++)
+          for (unsigned j = 0; j < size_(cbv); j++)
+            output.values[j * cbvBits / wordBits] |= ((Word) cbv[j]) << ((j * cbvBits) % wordBits);
+
+          for (int w = 0; w < output.numberOfWords(); w++)
             {
-              output.setFixed(j, true);
-              output.setValue(j, CONSTANTBV::BitVector_bit_test(cbv, j));
+              output.fixed[w] = output.wordMask(w);
+              output.values[w] &= output.wordMask(w);
             }
         }
       else
@@ -353,54 +332,23 @@ namespace simplifier
     {
       FixedBits output(width, false);
 
-      const unsigned maxWidth = std::max((int) sizeof(unsigned) * 8, width);
-      for (unsigned i = 0; i < maxWidth; i++)
-        {
-          if (i < (unsigned) width && i < sizeof(unsigned) * 8)
-            {
-              output.setFixed(i, true);
-              output.setValue(i, (val & (1 << i)));
-            }
-          else if (i < (unsigned) width)
-            {
-              output.setFixed(i, true);
-              output.setValue(i, false);
+      // The unsigned value is bigger than the bitwidth of this.
+      if (width < wordBits && (((Word) val) & ~output.wordMask(0)) != 0)
+        BEEV::FatalError(LOCATION "Cant be represented.");
 
-            }
-          else // The unsigned value is bigger than the bitwidth of this.
-            { // so it can't be represented.
-              if (val & (1 << i))
-                {
-                  BEEV::FatalError(LOCATION "Cant be represented.");
-                }
-            }
-        }
+      output.fromUnsigned(val);
       return output;
     }
 
 
+    // Any bits of "val" past the width are ignored.
     void
     FixedBits::fromUnsigned(unsigned val)
     {
-      for (unsigned i = 0; i < width; i++)
+      for (int w = 0; w < numberOfWords(); w++)
         {
-          if (i < (unsigned) width && i < sizeof(unsigned) * 8)
-            {
-              setFixed(i, true);
-              setValue(i, (val & (1 << i)));
-            }
-          else if (i < (unsigned) width)
-            {
-              setFixed(i, true);
-              setValue(i, false);
-            }
-          else // The unsigned value is bigger than the bitwidth of this.
-            { // so it can't be represented.
-              if (val & (1 << i))
-                {
-                  BEEV::FatalError(LOCATION "Cant be represented.");
-                }
-            }
+          fixed[w] = wordMask(w);
+          values[w] = (w == 0) ? (val & wordMask(0)) : 0;
         }
     }
 
@@ -409,14 +357,7 @@ namespace simplifier
     {
       assert(isTotallyFixed());
       assert(getWidth() <= 32);
-      int result = 0;
-
-      for (int i = 0; i < width; i++)
-        {
-          if (getValue(i))
-            result += (1 << i);
-        }
-      return result;
+      return (int) values[0];
     }
 
     bool
@@ -425,20 +366,10 @@ namespace simplifier
       assert (n.getWidth() >= upTo);
       assert (o.getWidth() >= upTo);
 
-      for (int i = 0; i < upTo; i++)
-        {
-          if (n.isFixed(i) && o.isFixed(i))
-            {
-              if (n.getValue(i) != o.getValue(i))
-                {
-                  return false;
-                }
-            }
-          else if (o.isFixed(i) && !n.isFixed(i))
-            {
-              return false;
-            }
-        }
+      // Bits that were fixed must stay fixed to the same value.
+      for (int w = 0; w * wordBits < upTo; w++)
+        if ((o.fixed[w] & (~n.fixed[w] | (n.values[w] ^ o.values[w])) & prefixMask(w, upTo)) != 0)
+          return false;
       return true;
     }
 
@@ -450,21 +381,7 @@ namespace simplifier
       if (n.getWidth() != o.getWidth())
         return false;
 
-      for (int i = 0; i < n.getWidth(); i++)
-        {
-          if (n.isFixed(i) && o.isFixed(i))
-            {
-              if (n.getValue(i) != o.getValue(i))
-                {
-                  return false;
-                }
-            }
-          else if (o.isFixed(i) && !n.isFixed(i))
-            {
-              return false;
-            }
-        }
-      return true;
+      return updateOK(o, n, n.getWidth());
     }
 
     // a is "IN" b.
@@ -473,13 +390,11 @@ namespace simplifier
     {
       assert(a.getWidth() == b.getWidth());
 
-      for (int i = 0; i < a.getWidth(); i++)
+      for (int w = 0; w < a.numberOfWords(); w++)
         {
-          if (a.isFixed(i) && b.isFixed(i) && (a.getValue(i) != b.getValue(i)))
-            {
-              return false;
-            }
-          if (!a.isFixed(i) && b.isFixed(i))
+          if ((a.fixed[w] & b.fixed[w] & (a.values[w] ^ b.values[w])) != 0)
+            return false;
+          if ((~a.fixed[w] & b.fixed[w]) != 0)
             return false;
         }
       return true;
@@ -490,35 +405,22 @@ namespace simplifier
     void
     FixedBits::getUnsignedMinMax(unsigned &minShift, unsigned &maxShift) const
     {
-      const int bitWidth = this->getWidth();
-      int unsignedBW = sizeof(unsigned)*8;
+      const Word low = (Word) UINT_MAX;
 
-      minShift = 0;
-      maxShift = 0;
+      minShift = getOnesWord(0) & low;
+      maxShift = ~getZeroesWord(0) & wordMask(0) & low;
 
       bool bigMax = false;
       bool bigMin = false;
 
-      for (int i = unsignedBW; i < bitWidth; i++)
+      // Any bits above those of an unsigned.
+      for (int w = 0; w < numberOfWords(); w++)
         {
-        if  ((*this)[i] == '1' || (*this)[i] == '*')
-          bigMax = true;
-
-         if ((*this)[i] == '1')
-          bigMin = true;
-        }
-
-      for (int i = 0; i < std::min(unsignedBW,bitWidth); i++)
-        {
-          if ((*this)[i] == '1')
-            {
-              minShift |= (1 <<i);
-              maxShift |= (1 <<i);
-            }
-          else if ((*this)[i] == '*')
-            {
-              maxShift |= (1 <<i);
-            }
+          const Word high = (w == 0) ? ~low : ~(Word) 0;
+          if ((~getZeroesWord(w) & wordMask(w) & high) != 0)
+            bigMax = true;
+          if ((getOnesWord(w) & high) != 0)
+            bigMin = true;
         }
 
       if (bigMax)
@@ -534,15 +436,11 @@ namespace simplifier
       assert (a.getWidth() >= upTo);
       assert (b.getWidth() >= upTo);
 
-      for (int i = 0; i < upTo; i++)
+      for (int w = 0; w * wordBits < upTo; w++)
         {
-          if (a.isFixed(i) != b.isFixed(i))
-            {
-              return false;
-            }
-          if (a.isFixed(i))
-            if (a.getValue(i) != b.getValue(i))
-              return false;
+          const Word different = (a.fixed[w] ^ b.fixed[w]) | (a.fixed[w] & (a.values[w] ^ b.values[w]));
+          if ((different & prefixMask(w, upTo)) != 0)
+            return false;
         }
       return true;
     }
@@ -553,17 +451,32 @@ namespace simplifier
       if (a.getWidth() != b.getWidth())
         return false;
 
-      for (int i = 0; i < a.getWidth(); i++)
+      return equals(a, b, a.getWidth());
+    }
+
+    void
+    FixedBits::replaceWithContents(const FixedBits& a)
+    {
+      assert(getWidth() >= a.getWidth());
+
+      for (int w = 0; w < a.numberOfWords(); w++)
         {
-          if (a.isFixed(i) != b.isFixed(i))
-            {
-              return false;
-            }
-          if (a.isFixed(i))
-            if (a.getValue(i) != b.getValue(i))
-              return false;
+          const Word m = a.wordMask(w);
+          fixed[w] = (fixed[w] & ~m) | a.fixed[w];
+          values[w] = (values[w] & ~a.fixed[w]) | (a.values[w] & a.fixed[w]);
+        }
+    }
+
+    void
+    FixedBits::copyIn(const FixedBits& a)
+    {
+      const int to = std::min(getWidth(), a.getWidth());
+      for (int w = 0; w * wordBits < to; w++)
+        {
+          const Word m = prefixMask(w, to);
+          assert((fixed[w] & m) == 0);
+          fixWord(w, a.fixed[w] & m, a.values[w]);
         }
-      return true;
     }
   }
 }
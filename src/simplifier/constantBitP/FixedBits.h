@@ -4,6 +4,7 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <stdint.h>
 
 class MTRand;
 
@@ -24,17 +25,40 @@ namespace simplifier
 #define CONSTANTBITP_UTILITY_XSTR(s) CONSTANTBITP_UTILITY_STR(s)
 #define LOCATION __FILE__ ":"  CONSTANTBITP_UTILITY_XSTR(__LINE__) ": "
 
-    static int staticUniqueId = 1;
+    static __thread int staticUniqueId = 1;
 
     // Bits can be fixed, or unfixed. Fixed bits are fixed to either zero or one.
+    //
+    // The bits are packed into 64-bit words so that the transfer functions can
+    // work on a word of columns at a time. Bit i is bit (i % 64) of word (i / 64).
+    // The bits past the width are always zero in both masks.
     class FixedBits
     {
+    public:
+      typedef uint64_t Word;
+      static const int wordBits = 64;
+
     private:
-      bool* fixed;
-      bool* values;
+      // Up to this many words are stored in the object, so most FixedBits
+      // don't allocate.
+      static const int inlineWords = 2;
+
+      Word* fixed;
+      Word* values;
+      Word inlineStore[2 * inlineWords];
       int width;
       bool representsBoolean;
 
+      void
+      allocate(int n);
+
+      void
+      release()
+      {
+        if (fixed != inlineStore)
+          delete[] fixed;
+      }
+
       void
       init(const FixedBits& copy);
       int uniqueId;
@@ -44,6 +68,11 @@ namespace simplifier
       bool
       unsignedHolds_old(unsigned val);
 
+      static Word
+      bit(int n)
+      {
+        return ((Word) 1) << (n % wordBits);
+      }
 
     public:
       FixedBits(int n, bool isBoolean);
@@ -63,8 +92,7 @@ namespace simplifier
 
       ~FixedBits()
       {
-        delete[] fixed;
-        delete[] values;
+        release();
       }
 
       bool
@@ -97,8 +125,7 @@ namespace simplifier
       {
         if (this == &copy)
           return *this;
-        delete[] fixed;
-        delete[] values;
+        release();
         init(copy);
         return *this;
       }
@@ -126,103 +153,166 @@ namespace simplifier
       setValue(int n, bool value)
       {
         assert(((char)value) == 0 || (char)value ==1 );
-        assert(n >=0 && n <width && fixed[n]);
-        values[n] = value;
+        assert(n >=0 && n <width && isFixed(n));
+        if (value)
+          values[n / wordBits] |= bit(n);
+        else
+          values[n / wordBits] &= ~bit(n);
       }
 
       bool
       getValue(int n) const
       {
-        assert(n >=0 && n <width && fixed[n]);
-        return values[n];
+        assert(n >=0 && n <width && isFixed(n));
+        return (values[n / wordBits] & bit(n)) != 0;
+      }
+
+      //////// Word at a time access.
+
+      int
+      numberOfWords() const
+      {
+        return (width + wordBits - 1) / wordBits;
+      }
+
+      // The bits of word "w" that are inside the width.
+      Word
+      wordMask(int w) const
+      {
+        assert(w >= 0 && w < numberOfWords());
+        if (w == numberOfWords() - 1 && (width % wordBits) != 0)
+          return (((Word) 1) << (width % wordBits)) - 1;
+        return ~(Word) 0;
+      }
+
+      Word
+      getFixedWord(int w) const
+      {
+        assert(w >= 0 && w < numberOfWords());
+        return fixed[w];
+      }
+
+      // Only the bits that are fixed are meaningful.
+      Word
+      getValueWord(int w) const
+      {
+        assert(w >= 0 && w < numberOfWords());
+        return values[w];
+      }
+
+      // Fixes the bits of word "w" that are in "mask" to the bits of "value".
+      void
+      fixWord(int w, Word mask, Word value)
+      {
+        assert((mask & ~wordMask(w)) == 0);
+        fixed[w] |= mask;
+        values[w] = (values[w] & ~mask) | (value & mask);
+      }
+
+      // Unfixes the bits of word "w" that are in "mask".
+      void
+      unfixWord(int w, Word mask)
+      {
+        assert(w >= 0 && w < numberOfWords());
+        fixed[w] &= ~mask;
       }
 
+      // The bits of word "w" that are below bit "upTo".
+      static Word
+      prefixMask(int w, int upTo)
+      {
+        if ((w + 1) * wordBits <= upTo)
+          return ~(Word) 0;
+        if (w * wordBits >= upTo)
+          return 0;
+        return bit(upTo) - 1;
+      }
+
+      // The fixed bits that are one.
+      Word
+      getOnesWord(int w) const
+      {
+        return getFixedWord(w) & getValueWord(w);
+      }
+
+      // The fixed bits that are zero.
+      Word
+      getZeroesWord(int w) const
+      {
+        return getFixedWord(w) & ~getValueWord(w);
+      }
+
+      ////////
+
       //returns -1 if it's zero.
       int
       topmostPossibleLeadingOne()
       {
-        int i = 0;
-        for (i = getWidth() - 1; i >= 0; i--)
+        for (int w = numberOfWords() - 1; w >= 0; w--)
           {
-            if (!isFixed(i) || getValue(i))
-              break;
+            const Word possible = ~getZeroesWord(w) & wordMask(w);
+            if (possible != 0)
+              return w * wordBits + (wordBits - 1 - __builtin_clzll(possible));
           }
-        return i;
+        return -1;
       }
 
       int
       minimum_trailingOne()
       {
-        int i = 0;
-        for (; i < getWidth(); i++)
-          {
-            if (!isFixed(i) || getValue(i))
-              break;
-          }
-        return i;
+        return minimum_numberOfTrailingZeroes();
       }
 
       int
       maximum_trailingOne()
       {
-        int i = 0;
-        for (; i < getWidth(); i++)
-          {
-            if (isFixed(i) && getValue(i))
-              break;
-          }
-        return i;
+        return maximum_numberOfTrailingZeroes();
       }
 
-
-
       int
       minimum_numberOfTrailingZeroes()
       {
-        int i = 0;
-        for (; i < getWidth(); i++)
+        for (int w = 0; w < numberOfWords(); w++)
           {
-            if (!isFixed(i) || getValue(i))
-              break;
+            const Word possible = ~getZeroesWord(w) & wordMask(w);
+            if (possible != 0)
+              return w * wordBits + __builtin_ctzll(possible);
           }
-        return i;
+        return width;
       }
 
       int
       maximum_numberOfTrailingZeroes()
       {
-        int i = 0;
-        for (; i < getWidth(); i++)
-          {
-            if (isFixed(i) && getValue(i))
-              break;
-          }
-        return i;
+        for (int w = 0; w < numberOfWords(); w++)
+          if (getOnesWord(w) != 0)
+            return w * wordBits + __builtin_ctzll(getOnesWord(w));
+        return width;
       }
 
       //Returns the position of the first non-fixed value.
       int
       leastUnfixed() const
       {
-        int i = 0;
-        for (; i < getWidth(); i++)
+        for (int w = 0; w < numberOfWords(); w++)
           {
-            if (!isFixed(i))
-              break;
+            const Word unfixed = ~fixed[w] & wordMask(w);
+            if (unfixed != 0)
+              return w * wordBits + __builtin_ctzll(unfixed);
           }
-        return i;
+        return width;
       }
 
       int
       mostUnfixed() const
       {
-        int i = getWidth()-1;
-        for (; i >=0; i--)
+        for (int w = numberOfWords() - 1; w >= 0; w--)
           {
-            if (!isFixed(i))
-              break;
+            const Word unfixed = ~fixed[w] & wordMask(w);
+            if (unfixed != 0)
+              return w * wordBits + (wordBits - 1 - __builtin_clzll(unfixed));
           }
-        return i;
+        return -1;
       }
 
       // is this bit fixed to zero?
@@ -244,7 +334,7 @@ namespace simplifier
       isFixed(int n) const
       {
         assert(n >=0 && n <width);
-        return fixed[n];
+        return (fixed[n / wordBits] & bit(n)) != 0;
       }
 
       // set bit n to either fixed or unfixed.
@@ -253,7 +343,10 @@ namespace simplifier
       {
         assert(((char)value) == 0 || (char)value ==1 );
         assert(n >=0 && n <width);
-        fixed[n] = value;
+        if (value)
+          fixed[n / wordBits] |= bit(n);
+        else
+          fixed[n / wordBits] &= ~bit(n);
       }
 
 
@@ -262,46 +355,17 @@ namespace simplifier
       unsignedHolds(unsigned val);
 
       void
-      replaceWithContents(const FixedBits& a)
-      {
-        assert(getWidth() >= a.getWidth());
-
-        for (int i = 0; i < a.getWidth(); i++)
-          {
-            if (a.isFixed(i))
-              {
-                setFixed(i, true);
-                setValue(i, a.getValue(i));
-              }
-            else
-              {
-                setFixed(i, false);
-              }
-          }
-      }
-
+      replaceWithContents(const FixedBits& a);
 
       void
-      copyIn(const FixedBits& a)
-      {
-        int to = std::min(getWidth(), a.getWidth());
-        for (int i = 0; i < to; i++)
-          {
-            assert(!isFixed(i));
-            if (a.isFixed(i))
-              {
-                setFixed(i, true);
-                setValue(i, a.getValue(i));
-              }
-          }
-      }
+      copyIn(const FixedBits& a);
 
       //todo merger with unsignedHolds()
       bool
       containsZero() const
       {
-        for (int i = 0; i < getWidth(); i++)
-          if (isFixed(i) && getValue(i))
+        for (int w = 0; w < numberOfWords(); w++)
+          if (getOnesWord(w) != 0)
             return false;
         return true;
       }
@@ -310,9 +374,8 @@ namespace simplifier
       countFixed() const
       {
         int result = 0;
-        for (unsigned i = 0; i < (unsigned) width; i++)
-          if (isFixed(i))
-            result++;
+        for (int w = 0; w < numberOfWords(); w++)
+          result += __builtin_popcountll(fixed[w]);
         return result;
       }
 
@@ -331,14 +394,8 @@ namespace simplifier
       mergeIn(const FixedBits& a)
       {
         assert(a.getWidth() == getWidth());
-        for (int i= 0; i < width;i++)
-          {
-          if (a.isFixed(i) && !isFixed(i))
-            {
-            setFixed(i,true);
-            setValue(i,a.getValue(i));
-            }
-          }
+        for (int w = 0; w < numberOfWords(); w++)
+          fixWord(w, a.fixed[w] & ~fixed[w], a.values[w]);
       }
 
 
@@ -6,6 +6,7 @@
 #define NODETOFIXEDBITSMAP_H_
 
 #include "../../AST/AST.h"
+#include "../../AST/NodeAttribute.h"
 #include "FixedBits.h"
 
 namespace simplifier
@@ -16,15 +17,13 @@ namespace simplifier
     class NodeToFixedBitsMap
     {
     public:
-      typedef BEEV::hash_map<BEEV::ASTNode, FixedBits*,
-          BEEV::ASTNode::ASTNodeHasher, BEEV::ASTNode::ASTNodeEqual>
-          NodeToFixedBitsMapType;
+      typedef BEEV::NodeAttribute<FixedBits*> NodeToFixedBitsMapType;
 
       NodeToFixedBitsMapType* map;
 
-      NodeToFixedBitsMap(int size)
+      NodeToFixedBitsMap()
       {
-        map = new NodeToFixedBitsMapType(size);
+        map = new NodeToFixedBitsMapType();
       }
       virtual
       ~NodeToFixedBitsMap()
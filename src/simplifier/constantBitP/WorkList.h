@@ -55,6 +55,10 @@ namespace simplifier
         initWorkList(top);
       }
 
+      WorkList()
+      {
+      }
+
       int size()
       {
         return cheap_workList.size() + expensive_workList.size();
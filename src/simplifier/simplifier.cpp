@@ -73,7 +73,7 @@ namespace BEEV
         return true;
       }
 
-    ASTNodeMap::iterator it, itend;
+    SimplifyMapType::iterator it, itend;
     it = pushNeg ? SimplifyNegMap->find(key) : SimplifyMap->find(key);
     itend = pushNeg ? SimplifyNegMap->end() : SimplifyMap->end();
 
@@ -1644,7 +1644,7 @@ namespace BEEV
     if (n.GetKind() == SYMBOL)
       return true;
 
-    ASTNodeMap::const_iterator it;
+    SimplifyMapType::const_iterator it;
     //If it's in the simplification map, it has been simplified.
     if ((it = SimplifyMap->find(n)) == SimplifyMap->end())
       return false;
@@ -3889,26 +3889,16 @@ namespace BEEV
   void
   Simplifier::ResetSimplifyMaps()
   {
-    // clear() is extremely expensive for hash_maps with a lot of
-    // buckets, in the EXT_MAP implementation it visits every bucket,
-    // checking whether each bucket is empty or not, if non-empty it
-    // deletes the contents.  The destructor seems to clear everything
-    // anyway.
-
-    //SimplifyMap->clear();
-    delete SimplifyMap;
-    SimplifyMap = new ASTNodeMap(INITIAL_TABLE_SIZE);
-
-    //SimplifyNegMap->clear();
-    delete SimplifyNegMap;
-    SimplifyNegMap = new ASTNodeMap(INITIAL_TABLE_SIZE);
+    // Unlike a hash_map's, clear() gives the memory back.
+    SimplifyMap->clear();
+    SimplifyNegMap->clear();
   }
 
   void
   Simplifier::printCacheStatus()
   {
-    cerr << "SimplifyMap:" << SimplifyMap->size() << ":" << SimplifyMap->bucket_count() << endl;
-    cerr << "SimplifyNegMap:" << SimplifyNegMap->size() << ":" << SimplifyNegMap->bucket_count() << endl;
+    cerr << "SimplifyMap:" << SimplifyMap->size() << endl;
+    cerr << "SimplifyNegMap:" << SimplifyNegMap->size() << endl;
     cerr << "AlwaysTrueFormSet" << AlwaysTrueHashSet.size() << ":" << AlwaysTrueHashSet.bucket_count() << endl;
     cerr << "MultInverseMap" << MultInverseMap.size() << ":" << MultInverseMap.bucket_count() << endl;
 
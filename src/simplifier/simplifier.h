@@ -11,6 +11,7 @@
 #define SIMPLIFIER_H
 
 #include "../AST/AST.h"
+#include "../AST/NodeAttribute.h"
 #include "../STPManager/STPManager.h"
 #include "../AST/NodeFactory/SimplifyingNodeFactory.h"
 #include "SubstitutionMap.h"
@@ -35,8 +36,9 @@ namespace BEEV
 
     // Memo table for simplifcation. Key is unsimplified node, and
     // value is simplified node.
-    ASTNodeMap * SimplifyMap;
-    ASTNodeMap * SimplifyNegMap;
+    typedef NodeAttribute<ASTNode> SimplifyMapType;
+    SimplifyMapType * SimplifyMap;
+    SimplifyMapType * SimplifyNegMap;
     HASHSET<int> AlwaysTrueHashSet;
     ASTNodeMap MultInverseMap;
 
@@ -72,8 +74,8 @@ namespace BEEV
     Simplifier(STPMgr * bm) : _bm(bm),
     substitutionMap(this,bm)
     {
-      SimplifyMap    = new ASTNodeMap(INITIAL_TABLE_SIZE);
-      SimplifyNegMap = new ASTNodeMap(INITIAL_TABLE_SIZE);
+      SimplifyMap    = new SimplifyMapType();
+      SimplifyNegMap = new SimplifyMapType();
       //ReadOverWrite_NewName_Map = new ASTNodeMap();
 
       ASTTrue  = bm->CreateNode(TRUE);
@@ -17,6 +17,7 @@
 #include "../../extlib-abc/cnf_short.h"
 #include "../../extlib-abc/dar.h"
 #include "../ToSATBase.h"
+#include "../../AST/NodeAttribute.h"
 
 typedef Cnf_Dat_t_ CNFData;
 typedef Aig_Obj_t AIGNode;
@@ -35,7 +36,7 @@ public:
         Aig_Man_t *aigMgr;
 
         // Map from symbols to their AIG nodes.
-        typedef map<ASTNode, vector<BBNodeAIG> > SymbolToBBNode;
+        typedef NodeAttribute<vector<BBNodeAIG> > SymbolToBBNode;
 
         SymbolToBBNode symbolToBBNode;
 
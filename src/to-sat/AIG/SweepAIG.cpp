@@ -0,0 +1,369 @@
+#include "SweepAIG.h"
+#include "../../sat/MinisatCore.h"
+#include "../../sat/utils/System.h"
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+
+namespace BEEV
+{
+  namespace
+  {
+    // Words of random patterns simulated at the start.
+    const int randomWords = 4;
+
+    // Words of counterexamples simulated at most. Each holds 64.
+    const int maxCexWords = 16;
+
+    // Earlier objects with the same signature that are tried before a node
+    // is kept as it is.
+    const int tries = 2;
+
+    // SAT calls in a row that may prove nothing before the sweep gives up.
+    const int maxFailures = 1000;
+
+    class Sweeper
+    {
+      Aig_Man_t* p;
+      Aig_Man_t* pNew;
+      const int conflicts;
+      const double deadline;
+
+      // The objects of p in topological order: the constant, the PIs, then
+      // the nodes.
+      std::vector<Aig_Obj_t*> order;
+
+      // sim[k][Id] is the k-th word of patterns for the object.
+      std::vector<std::vector<uint64_t> > sim;
+
+      // The objects, sorted so that those with the same signature are next
+      // to each other, in order. first[Id] is the index in sorted of the
+      // first with the object's signature, index[Id] the object's own.
+      std::vector<int> sorted;
+      std::vector<int> first;
+      std::vector<int> index;
+
+      // The counterexamples that aren't simulated yet, a word per PI.
+      std::vector<uint64_t> cex;
+      int cexCount;
+
+      volatile bool interrupt;
+      MinisatCore<Minisat::Solver> solver;
+
+      // The SAT variable of each object of pNew, or -1.
+      std::vector<int> satVar;
+
+      // Signatures are compared with the first pattern false, so that
+      // complemented objects match too.
+      bool
+      phase(int id) const
+      {
+        return sim[0][id] & 1;
+      }
+
+      uint64_t
+      normalised(int id, int k) const
+      {
+        return phase(id) ? ~sim[k][id] : sim[k][id];
+      }
+
+      struct ByWords
+      {
+        const Sweeper& s;
+        const int from, to;
+
+        ByWords(const Sweeper& _s, int _from, int _to) :
+          s(_s), from(_from), to(_to)
+        {
+        }
+
+        bool
+        operator()(int a, int b) const
+        {
+          for (int k = from; k < to; k++)
+            if (s.normalised(a, k) != s.normalised(b, k))
+              return s.normalised(a, k) < s.normalised(b, k);
+          return false;
+        }
+      };
+
+      // Simulates word k, with the given word for each PI.
+      void
+      simulate(int k, const std::vector<uint64_t>& pis)
+      {
+        std::vector<uint64_t>& v = sim[k];
+        v.resize(Aig_ManObjNumMax(p));
+        v[Aig_ManConst1(p)->Id] = ~(uint64_t) 0;
+        for (int i = 0; i < Aig_ManPiNum(p); i++)
+          v[Aig_ManPi(p, i)->Id] = pis[i];
+        for (unsigned j = 1 + Aig_ManPiNum(p); j < order.size(); j++)
+          {
+            Aig_Obj_t* o = order[j];
+            const uint64_t a = v[Aig_ObjFanin0(o)->Id] ^ (Aig_ObjFaninC0(o) ? ~(uint64_t) 0 : 0);
+            const uint64_t b = v[Aig_ObjFanin1(o)->Id] ^ (Aig_ObjFaninC1(o) ? ~(uint64_t) 0 : 0);
+            v[o->Id] = a & b;
+          }
+      }
+
+      // Splits the classes by words [from, to). The objects stay in order
+      // within a class.
+      void
+      refine(int from, int to)
+      {
+        unsigned b = 0;
+        while (b < sorted.size())
+          {
+            unsigned e = b + 1;
+            while (e < sorted.size() && first[sorted[e]] == (int) b)
+              e++;
+            if (e - b > 1)
+              {
+                std::stable_sort(sorted.begin() + b, sorted.begin() + e, ByWords(*this, from, to));
+                for (unsigned j = b; j < e; j++)
+                  {
+                    index[sorted[j]] = j;
+                    const bool same = j > b && !ByWords(*this, from, to)(sorted[j - 1], sorted[j]);
+                    first[sorted[j]] = same ? first[sorted[j - 1]] : j;
+                  }
+              }
+            b = e;
+          }
+      }
+
+      // Simulates the counterexamples found since the last call, and splits
+      // the classes they tell apart.
+      void
+      flush()
+      {
+        if (cexCount == 0)
+          return;
+        sim.push_back(std::vector<uint64_t>());
+        simulate(sim.size() - 1, cex);
+        refine(sim.size() - 1, sim.size());
+        std::fill(cex.begin(), cex.end(), 0);
+        cexCount = 0;
+      }
+
+      // Keeps the PIs of the SAT solver's model.
+      void
+      counterexample()
+      {
+        if ((int) sim.size() >= randomWords + maxCexWords)
+          return;
+        Aig_Obj_t* pi;
+        int i;
+        Aig_ManForEachPi(pNew, pi, i)
+          if (encoded(pi) && solver.modelValue(satVar[pi->Id]) == solver.true_literal())
+            cex[i] |= (uint64_t) 1 << cexCount;
+        if (++cexCount == 64)
+          flush();
+      }
+
+      bool
+      encoded(Aig_Obj_t* o) const
+      {
+        return o->Id < (int) satVar.size() && satVar[o->Id] != -1;
+      }
+
+      // Gives the object of pNew, and the cone beneath it, SAT variables.
+      void
+      encode(Aig_Obj_t* root)
+      {
+        std::vector<Aig_Obj_t*> stack(1, root);
+        while (!stack.empty())
+          {
+            Aig_Obj_t* o = stack.back();
+            if (encoded(o))
+              {
+                stack.pop_back();
+                continue;
+              }
+
+            SATSolver::vec_literals clause;
+            int v;
+            if (Aig_ObjIsConst1(o))
+              {
+                v = solver.newVar();
+                clause.push(SATSolver::mkLit(v, false));
+                solver.addClause(clause);
+              }
+            else if (Aig_ObjIsPi(o))
+              v = solver.newVar();
+            else
+              {
+                Aig_Obj_t* f0 = Aig_ObjFanin0(o);
+                Aig_Obj_t* f1 = Aig_ObjFanin1(o);
+                if (!encoded(f0) || !encoded(f1))
+                  {
+                    if (!encoded(f0))
+                      stack.push_back(f0);
+                    if (!encoded(f1))
+                      stack.push_back(f1);
+                    continue;
+                  }
+                v = solver.newVar();
+                const Minisat::Lit out = SATSolver::mkLit(v, false);
+                const Minisat::Lit a = SATSolver::mkLit(satVar[f0->Id], Aig_ObjFaninC0(o));
+                const Minisat::Lit b = SATSolver::mkLit(satVar[f1->Id], Aig_ObjFaninC1(o));
+                clause.push(~out);
+                clause.push(a);
+                solver.addClause(clause);
+                clause.clear();
+                clause.push(~out);
+                clause.push(b);
+                solver.addClause(clause);
+                clause.clear();
+                clause.push(out);
+                clause.push(~a);
+                clause.push(~b);
+                solver.addClause(clause);
+              }
+            if (o->Id >= (int) satVar.size())
+              satVar.resize(Aig_ManObjNumMax(pNew), -1);
+            satVar[o->Id] = v;
+            stack.pop_back();
+          }
+      }
+
+      Minisat::Lit
+      literal(Aig_Obj_t* o)
+      {
+        encode(Aig_Regular(o));
+        return SATSolver::mkLit(satVar[Aig_Regular(o)->Id], Aig_IsComplement(o));
+      }
+
+      // Whether the SAT solver shows that a can't be true while b is false.
+      // Keeps the counterexample if it finds one.
+      bool
+      implies(const Minisat::Lit& a, const Minisat::Lit& b)
+      {
+        SATSolver::vec_literals assumps;
+        assumps.push(a);
+        assumps.push(~b);
+        solver.setConflictBudget(conflicts);
+        const SATSolver::lbool result = solver.solveLimited(assumps);
+        if (result == solver.true_literal())
+          counterexample();
+        return result == solver.false_literal();
+      }
+
+      // Whether objects a and b of pNew are equal on every input.
+      bool
+      equivalent(Aig_Obj_t* a, Aig_Obj_t* b)
+      {
+        if (a == b)
+          return true;
+        if (a == Aig_Not(b))
+          return false;
+        const Minisat::Lit x = literal(a);
+        const Minisat::Lit y = literal(b);
+        return implies(x, y) && implies(y, x);
+      }
+
+    public:
+      Sweeper(Aig_Man_t* _p, int _conflicts, double _deadline) :
+        p(_p), pNew(NULL), conflicts(_conflicts), deadline(_deadline), cexCount(0), interrupt(false), solver(interrupt)
+      {
+      }
+
+      Aig_Man_t*
+      sweep()
+      {
+        Aig_Obj_t* o;
+        int i;
+
+        order.push_back(Aig_ManConst1(p));
+        Aig_ManForEachPi(p, o, i)
+          order.push_back(o);
+        Vec_Ptr_t* vNodes = Aig_ManDfs(p);
+        Vec_PtrForEachEntry(vNodes, o, i)
+          {
+            assert(Aig_ObjIsAnd(o));
+            order.push_back(o);
+          }
+        Vec_PtrFree(vNodes);
+
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        std::vector<uint64_t> pis(Aig_ManPiNum(p));
+        sim.resize(randomWords);
+        for (int k = 0; k < randomWords; k++)
+          {
+            for (unsigned j = 0; j < pis.size(); j++)
+              {
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                pis[j] = seed;
+              }
+            simulate(k, pis);
+          }
+
+        // Starts with one class, in order.
+        sorted.resize(order.size());
+        first.resize(Aig_ManObjNumMax(p), -1);
+        index.resize(Aig_ManObjNumMax(p), -1);
+        for (unsigned j = 0; j < order.size(); j++)
+          {
+            sorted[j] = order[j]->Id;
+            first[order[j]->Id] = 0;
+          }
+        refine(0, randomWords);
+        cex.resize(Aig_ManPiNum(p), 0);
+
+        pNew = Aig_ManStart(Aig_ManObjNumMax(p));
+        Aig_ManCleanData(p);
+        Aig_ManConst1(p)->pData = Aig_ManConst1(pNew);
+        Aig_ManForEachPi(p, o, i)
+          o->pData = Aig_ObjCreatePi(pNew);
+
+        // Objects that were replaced by an earlier one.
+        std::vector<bool> merged(Aig_ManObjNumMax(p), false);
+        bool outOfTime = false;
+        int failures = 0;
+        for (unsigned j = 1 + Aig_ManPiNum(p); j < order.size(); j++)
+          {
+            o = order[j];
+            o->pData = Aig_And(pNew, Aig_ObjChild0Copy(o), Aig_ObjChild1Copy(o));
+
+            if (failures >= maxFailures || ((j & 255) == 0 && Minisat::cpuTime() > deadline))
+              outOfTime = true;
+
+            // Candidates that failed are told apart once their counterexample
+            // is simulated, until then they're skipped.
+            std::vector<int> failed;
+            while (!outOfTime && (int) failed.size() < tries)
+              {
+                Aig_Obj_t* r = NULL;
+                for (int k = first[o->Id]; k < index[o->Id] && r == NULL; k++)
+                  if (!merged[sorted[k]] && std::find(failed.begin(), failed.end(), sorted[k]) == failed.end())
+                    r = Aig_ManObj(p, sorted[k]);
+                if (r == NULL)
+                  break;
+                Aig_Obj_t* to = Aig_NotCond((Aig_Obj_t*) r->pData, phase(r->Id) != phase(o->Id));
+                if (equivalent((Aig_Obj_t*) o->pData, to))
+                  {
+                    o->pData = to;
+                    merged[o->Id] = true;
+                    failures = 0;
+                    break;
+                  }
+                failed.push_back(r->Id);
+                failures++;
+              }
+          }
+
+        Aig_ManForEachPo(p, o, i)
+          Aig_ObjCreatePo(pNew, Aig_ObjChild0Copy(o));
+        Aig_ManCleanup(pNew);
+        return pNew;
+      }
+    };
+  }
+
+  Aig_Man_t*
+  sweepAIG(Aig_Man_t* p, int conflicts, double deadline)
+  {
+    Sweeper s(p, conflicts, deadline);
+    return s.sweep();
+  }
+}
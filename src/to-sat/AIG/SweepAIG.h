@@ -0,0 +1,17 @@
+#ifndef SWEEPAIG_H_
+#define SWEEPAIG_H_
+
+#include "../../extlib-abc/aig.h"
+
+namespace BEEV {
+
+// SAT sweeping ("fraiging"). Returns a copy of the AIG in which nodes that
+// are equivalent to an earlier node, or to a constant, are replaced by it.
+// Random simulation finds the candidates and a SAT call proves each. A
+// proof that takes more than "conflicts" conflicts is given up on, and no
+// more proofs are tried once the CPU time passes "deadline" seconds. The
+// PIs and POs are kept in order. The caller stops the original.
+Aig_Man_t* sweepAIG(Aig_Man_t* p, int conflicts, double deadline);
+
+}
+#endif /* SWEEPAIG_H_ */
@@ -1,4 +1,7 @@
 #include "ToCNFAIG.h"
+#include "SweepAIG.h"
+#include "XorAIG.h"
+#include "../../sat/utils/System.h"
 
 
 namespace BEEV
@@ -30,15 +33,81 @@ void addVariables(BBNodeManagerAIG& mgr, Cnf_Dat_t*& cnfData , ToSATBase::ASTNod
 	}
 }
 
+// Rewrites and sweeps the AIG in rounds, balancing it first if aig-balance
+// is set. It stops when a round removes less than aig-opt-min-gain percent
+// of the nodes, or the CPU time passes aig-opt-seconds. AIGs with more than
+// aig-opt-max-nodes nodes are left alone.
+void ToCNFAIG::optimise(BBNodeManagerAIG& mgr) {
+	const int maxNodes = atoi(uf.get("aig-opt-max-nodes", "1000000").c_str());
+	const double seconds = atof(uf.get("aig-opt-seconds", "10").c_str());
+	const int minGain = atoi(uf.get("aig-opt-min-gain", "2").c_str());
+	const int rounds = atoi(uf.get("aig-opt-rounds", "3").c_str());
+	const int conflicts = atoi(uf.get("aig-fraig-conflicts", "100").c_str());
+	const bool balance = uf.isSet("aig-balance", "0");
+	const bool fraig = uf.isSet("aig-fraig", "1");
+
+	int nodeCount = Aig_ManNodeNum(mgr.aigMgr);
+	if (nodeCount > maxNodes) {
+		if (uf.stats_flag)
+			cerr << "AIG too big to optimise" << endl;
+		return;
+	}
+
+	const double deadline = Minisat::cpuTime() + seconds;
+	Dar_LibStart();
+	Aig_Man_t * pTemp;
+	Dar_RwrPar_t Pars, *pPars = &Pars;
+	Dar_ManDefaultRwrParams(pPars);
+
+	// Assertion errors occur with this enabled.
+	// pPars->fUseZeros = 1;
+
+	// For mul63bit.smt2 with iterations =3 & nCutsMax = 8
+	// CNF generation was taking 139 seconds, solving 10 seconds.
+
+	// With nCutsMax =2, CNF generation takes 16 seconds, solving 10 seconds.
+	// The rewriting doesn't remove as many nodes of course..
+
+	for (int i = 0; i < rounds && Minisat::cpuTime() < deadline; i++) {
+		if (balance)
+			mgr.aigMgr = Dar_ManBalance(pTemp = mgr.aigMgr, 0);
+		else
+			mgr.aigMgr = Aig_ManDup(pTemp = mgr.aigMgr, 0);
+		Aig_ManStop(pTemp);
+		Dar_ManRewrite(mgr.aigMgr, pPars);
+
+		mgr.aigMgr = Aig_ManDup(pTemp = mgr.aigMgr, 0);
+		Aig_ManStop(pTemp);
+
+		if (fraig && Minisat::cpuTime() < deadline) {
+			mgr.aigMgr = sweepAIG(pTemp = mgr.aigMgr, conflicts, deadline);
+			Aig_ManStop(pTemp);
+		}
+
+		const int after = Aig_ManNodeNum(mgr.aigMgr);
+		if (uf.stats_flag)
+			cerr << "After AIG optimisation [" << i << "]  nodes:" << after
+					<< endl;
+
+		const bool worthwhile = (nodeCount - after) * 100.0 >= minGain * (double) nodeCount;
+		nodeCount = after;
+		if (!worthwhile)
+			break;
+	}
+	Dar_LibStop();
+}
+
 void ToCNFAIG::toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 		ToSATBase::ASTNodeToSATVar& nodeToVar,
-		bool needAbsRef, BBNodeManagerAIG& mgr) {
+		bool needAbsRef, BBNodeManagerAIG& mgr, bool stream,
+		vector<vector<int> >* xorClauses) {
 	assert(cnfData == NULL);
 
 	Aig_ObjCreatePo(mgr.aigMgr, top.n);
-	if (!needAbsRef) {
-		Aig_ManCleanup( mgr.aigMgr); // remove nodes not connected to the PO.
-	}
+
+	// Remove nodes not connected to the PO. The manager might hold what was
+	// bit-blasted for earlier versions of the formula.
+	Aig_ManCleanup( mgr.aigMgr);
 	Aig_ManCheck( mgr.aigMgr); // check that AIG looks ok.
 
 	assert(Aig_ManPoNum(mgr.aigMgr) == 1);
@@ -51,41 +120,28 @@ void ToCNFAIG::toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 	if (uf.stats_flag)
 		cerr << "Nodes before AIG rewrite:" << nodeCount << endl;
 
-	if (!needAbsRef && uf.isSet("aig-rewrite","0")) {
-		Dar_LibStart();
-		Aig_Man_t * pTemp;
-		Dar_RwrPar_t Pars, *pPars = &Pars;
-		Dar_ManDefaultRwrParams(pPars);
-
-		// Assertion errors occur with this enabled.
-		// pPars->fUseZeros = 1;
-
-		// For mul63bit.smt2 with iterations =3 & nCutsMax = 8
-		// CNF generation was taking 139 seconds, solving 10 seconds.
-
-		// With nCutsMax =2, CNF generation takes 16 seconds, solving 10 seconds.
-		// The rewriting doesn't remove as many nodes of course..
-		int iterations = 3;
-
-		for (int i = 0; i < iterations; i++) {
-			mgr.aigMgr = Aig_ManDup(pTemp = mgr.aigMgr, 0);
-			Aig_ManStop(pTemp);
-			Dar_ManRewrite(mgr.aigMgr, pPars);
-
-			mgr.aigMgr = Aig_ManDup(pTemp = mgr.aigMgr, 0);
-			Aig_ManStop(pTemp);
+	if (!needAbsRef && uf.isSet("aig-rewrite","0"))
+		optimise(mgr);
 
-			if (uf.stats_flag)
-				cerr << "After rewrite [" << i << "]  nodes:"
-						<< mgr.aigMgr->nObjs[AIG_OBJ_AND] << endl;
-
-			if (nodeCount == mgr.aigMgr->nObjs[AIG_OBJ_AND])
-				break;
-
-		}
+	// The XORs are taken out after optimising, which would make them again.
+	// Like optimising, this loses the nodes that the symbols were blasted
+	// to, so it can't be done if more might be blasted later.
+	vector<vector<Aig_Obj_t*> > xors;
+	int extraPos = 0;
+	if (xorClauses != NULL && !needAbsRef) {
+		Aig_Man_t * pTemp;
+		mgr.aigMgr = extractXors(pTemp = mgr.aigMgr, xors, extraPos);
+		Aig_ManStop(pTemp);
+		if (uf.stats_flag)
+			cerr << "XOR clauses:" << xors.size() << " nodes left:"
+					<< Aig_ManNodeNum(mgr.aigMgr) << endl;
 	}
+
 	if (!uf.isSet("simple-cnf","0")) {
-		cnfData = Cnf_Derive(mgr.aigMgr, 0);
+		if (stream)
+			cnfData = Cnf_DeriveForStream(mgr.aigMgr);
+		else
+			cnfData = Cnf_Derive(mgr.aigMgr, 0);
 		if (uf.stats_flag)
 		  cerr << "advanced CNF" << endl;
 	} else {
@@ -95,6 +151,22 @@ void ToCNFAIG::toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 
 	}
 
+	// The nodes in the XORs drive POs, so they've been given variables. The
+	// POs mustn't be asserted though. Their unit clauses are the last ones.
+	if (cnfData->vUnits != NULL)
+		Vec_IntShrink(cnfData->vUnits, Vec_IntSize(cnfData->vUnits) - extraPos);
+	else
+		cnfData->nClauses -= extraPos;
+	for (unsigned i = 0; i < xors.size(); i++) {
+		vector<int> clause;
+		for (unsigned j = 0; j < xors[i].size(); j++) {
+			Aig_Obj_t * pObj = xors[i][j];
+			clause.push_back(2 * cnfData->pVarNums[Aig_Regular(pObj)->Id]
+					+ (Aig_IsComplement(pObj) ^ (j == 0)));
+		}
+		xorClauses->push_back(clause);
+	}
+
 	BBNodeManagerAIG::SymbolToBBNode::const_iterator it;
 
 	assert(nodeToVar.size() == 0);
@@ -111,16 +183,24 @@ void ToCNFAIG::toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 		// INT_MAX for parts of symbols that didn't get encoded.
 		vector<unsigned> v(width, ~((unsigned) 0));
 
+		// Symbols that the formula doesn't depend on are left out, they
+		// may have been simplified away since they were bit-blasted. The
+		// bits of the others all keep their variables, the array
+		// propagators need every bit of an index or value.
+		bool used = false;
 		for (unsigned i = 0; i < b.size(); i++) {
 			if (!b[i].IsNull()) {
 				Aig_Obj_t * pObj;
 				pObj = (Aig_Obj_t*) Vec_PtrEntry(mgr.aigMgr->vPis,
 						b[i].symbol_index);
+				if (Aig_ObjRefs(pObj) != 0)
+					used = true;
 				v[i] = cnfData->pVarNums[pObj->Id];
 			}
 		}
 
-		nodeToVar.insert(make_pair(n, v));
+		if (used)
+			nodeToVar.insert(make_pair(n, v));
 	}
 	assert(cnfData != NULL);
 }
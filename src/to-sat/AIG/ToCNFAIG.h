@@ -14,15 +14,23 @@ class ToCNFAIG : boost::noncopyable
 {
 	UserDefinedFlags& uf;
 
+	void optimise(BBNodeManagerAIG& mgr);
+
 public:
 	ToCNFAIG(UserDefinedFlags& _uf):
 		uf(_uf)
 	{
 	}
 
+	// If stream is set, cnfData might only hold the variable numbers, and
+	// the clauses are written later by Cnf_DataStream(), which doesn't need
+	// the AIG. If xorClauses is set, the XORs are left out of the CNF and
+	// put there instead, each as the literals of which an odd number must
+	// be true.
 	void toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 			ToSATBase::ASTNodeToSATVar& nodeToVar,
-			bool needAbsRef,  BBNodeManagerAIG& _mgr);
+			bool needAbsRef,  BBNodeManagerAIG& _mgr, bool stream = false,
+			vector<vector<int> >* xorClauses = NULL);
 };
 
 }
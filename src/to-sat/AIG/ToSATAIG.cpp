@@ -1,11 +1,30 @@
 #include "ToSATAIG.h"
+#include <memory>
 #include "../../simplifier/constantBitP/ConstantBitPropagation.h"
 #include "../../simplifier/simplifier.h"
 
 namespace BEEV
 {
 
-    int ToSATAIG::cnf_calls=0;
+    __thread int ToSATAIG::cnf_calls=0;
+
+    SharedBitBlast::SharedBitBlast(STPMgr * bm) :
+        simp(new Simplifier(bm)), bb(&mgr, simp, bm->defaultNodeFactory, &bm->UserFlags)
+    {
+    }
+
+    SharedBitBlast::~SharedBitBlast()
+    {
+      bb.ClearAllTables();
+      delete simp;
+    }
+
+    // Passes a clause from ABC to the SAT solver. Stops at a conflict.
+    static int
+    addToSolver(void* satSolver, int* lits, int size)
+    {
+      return ((SATSolver*) satSolver)->addClause((const Minisat::Lit*) lits, size);
+    }
 
     bool
     ToSATAIG::CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef)
@@ -15,7 +34,11 @@ namespace BEEV
 
        if (!first)
        {
-    	   assert(input == ASTTrue);
+    	   if (input != ASTTrue)
+    	     {
+    	       assert(kept != NULL);
+    	       addFormula(satSolver, input);
+    	     }
     	   bm->GetRunTimes()->start(RunTimes::Solving);
            satSolver.solve();
            bm->GetRunTimes()->stop(RunTimes::Solving);
@@ -35,10 +58,16 @@ namespace BEEV
       if (input == ASTTrue  )
    		return true;
 
-  	  Simplifier simp(bm);
+      SharedBitBlast* blast = shared;
+      if (blast == NULL)
+        {
+          own.reset(new SharedBitBlast(bm));
+          blast = own.get();
+        }
 
-  	  BBNodeManagerAIG mgr;
-  	  BitBlaster<BBNodeAIG, BBNodeManagerAIG> bb(&mgr,&simp,bm->defaultNodeFactory,&bm->UserFlags,cb);
+      BBNodeManagerAIG& mgr = blast->mgr;
+      BitBlaster<BBNodeAIG, BBNodeManagerAIG>& bb = blast->bb;
+      bb.cb = cb;
 
       bm->GetRunTimes()->start(RunTimes::BitBlasting);
       BBNodeAIG BBFormula = bb.BBForm(input);
@@ -48,16 +77,43 @@ namespace BEEV
       cb = NULL;
       bb.cb = NULL;
 
+      // The CNF is made from the AIG alone.
+      bb.ClearAllTables();
+
    	  assert(satSolver.nVars() ==0);
 
+      // Unless the CNF is wanted on its own, its clauses are generated once
+      // the AIG has been freed, and go straight into the solver, rather than
+      // all being kept until they're sent.
+      const bool stream = bm->UserFlags.isSet("stream-cnf","1") && !bm->UserFlags.output_CNF_flag
+          && !bm->UserFlags.exit_after_CNF;
+
+      // Solvers that take XOR clauses get the AIG's XORs as they are. The CNF
+      // that's written out has to stand alone, so keeps them.
+      vector<vector<int> > xorClauses;
+      const bool xors = satSolver.acceptsXorClauses() && bm->UserFlags.isSet("native-xor", "1")
+          && !bm->UserFlags.output_CNF_flag && !bm->UserFlags.exit_after_CNF;
+
    	  bm->GetRunTimes()->start(RunTimes::CNFConversion);
       Cnf_Dat_t* cnfData = NULL;
-	  toCNF.toCNF(BBFormula, cnfData, nodeToSATVar,needAbsRef,mgr);
+	  toCNF.toCNF(BBFormula, cnfData, nodeToSATVar,needAbsRef,mgr,stream, xors ? &xorClauses : NULL);
       bm->GetRunTimes()->stop(RunTimes::CNFConversion);
 
-	  // Free the memory in the AIGs.
 	  BBFormula = BBNodeAIG(); // null node
-	  mgr.stop();
+
+      // The refinement adds array axioms after the first solve, except with
+      // the propagators solver, which handles arrays itself, and the
+      // definitions of abstracted multiplications and divisions. The AIG is
+      // kept so they can be converted like the rest and share its nodes.
+      if (needAbsRef && (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS
+          || bm->UserFlags.isSet("lazy-mult-div","0")) && bm->UserFlags.isSet("incremental-cnf","1"))
+        kept = blast;
+      else
+        {
+          // Free the memory in the AIGs.
+          mgr.stop();
+          own.reset();
+        }
 
       if (bm->UserFlags.output_CNF_flag)
       {
@@ -87,33 +143,38 @@ namespace BEEV
       for (int i = 0; i < cnfData->nVars - satV ; i++)
         satSolver.newVar();
 
-      SATSolver::vec_literals satSolverClause;
-      for (int i = 0; i < cnfData->nClauses; i++)
-        {
-          satSolverClause.clear();
-          for (int * pLit = cnfData->pClauses[i], *pStop = cnfData->pClauses[i
-              + 1]; pLit < pStop; pLit++)
-            {
-              SATSolver::Var var = (*pLit) >> 1;
-              assert ((var < satSolver.nVars()));
-              Minisat::Lit l = SATSolver::mkLit(var, (*pLit) & 1);
-              satSolverClause.push(l);
-            }
+      if (kept != NULL)
+        keepLiterals(satSolver, cnfData);
+
+      // ABC's literals are laid out like the solver's.
+      if (cnfData->vCuts != NULL)
+        Cnf_DataStream(cnfData, addToSolver, &satSolver);
 
-          satSolver.addClause(satSolverClause);
+      for (int i = 0; cnfData->pClauses != NULL && i < cnfData->nClauses; i++)
+        {
+          satSolver.addClause((const Minisat::Lit*) cnfData->pClauses[i],
+              cnfData->pClauses[i + 1] - cnfData->pClauses[i]);
           if (!satSolver.okay())
             break;
         }
+
+      SATSolver::vec_literals xorClause;
+      for (int i = 0; i < xorClauses.size() && satSolver.okay(); i++)
+        {
+          xorClause.clear();
+          for (int j = 0; j < xorClauses[i].size(); j++)
+            xorClause.push(Minisat::toLit(xorClauses[i][j]));
+          satSolver.addXorClause(xorClause);
+        }
       bm->GetRunTimes()->stop(RunTimes::SendingToSAT);
 
       if (bm->UserFlags.output_bench_flag)
         cerr << "Converting to CNF via ABC's AIG package can't yet print out bench format" << endl;
 
 
-      // This releases the memory used by the CNF generator, particularly some data tables.
-      // If CNF generation is going to be called lots, we'd rather keep it around.
-      // because the datatables are expensive to generate.
-       if (cnf_calls == 0)
+      // This releases the memory used by the CNF generator. The data tables it
+      // reads are shared by the process and kept, so restarting it is cheap.
+       if (cnf_calls == 0 && kept == NULL)
            Cnf_ClearMemory();
 
        cnf_calls++;
@@ -137,7 +198,8 @@ namespace BEEV
                             {
                                 const vector<unsigned>& v = it->second;
                                 for (int i = 0; i < v.size(); i++)
-                                    satSolver.setFrozen(v[i]);
+                                    if (v[i] != ~((unsigned) 0))
+                                        satSolver.setFrozen(v[i]);
                             }
 
                         ASTNodeToSATVar::iterator it2 = nodeToSATVar.find(ar.symbol);
@@ -145,7 +207,8 @@ namespace BEEV
                             {
                                 const vector<unsigned>& v = it2->second;
                                 for (int i = 0; i < v.size(); i++)
-                                    satSolver.setFrozen(v[i]);
+                                    if (v[i] != ~((unsigned) 0))
+                                        satSolver.setFrozen(v[i]);
                             }
                     }
             }
@@ -282,6 +345,214 @@ namespace BEEV
       return satSolver.okay();
     }
 
+    // Records the literals that the first CNF gave the AIG's nodes. A solver
+    // that eliminates variables might have removed the others by the time
+    // they're wanted, so it only gets the symbols' bits, which are frozen.
+    void
+    ToSATAIG::keepLiterals(SATSolver& satSolver, Cnf_Dat_t* cnfData)
+    {
+      Aig_Man_t* aigMgr = kept->mgr.aigMgr;
+      const bool eliminates = satSolver.eliminatesVariables();
+      nodeToLit.assign(Aig_ManObjNumMax(aigMgr), -1);
+
+      Aig_Obj_t* pObj;
+      int i;
+      Aig_ManForEachObj(aigMgr, pObj, i)
+        {
+          const int var = cnfData->pVarNums[pObj->Id];
+          if (var < 0 || (eliminates && !Aig_ObjIsPi(pObj)))
+            continue;
+          nodeToLit[pObj->Id] = var + var;
+          satSolver.setFrozen(var);
+        }
+    }
+
+    // The solver literal for a literal of a cone's CNF. The variables that
+    // aren't inputs get new solver variables when first seen.
+    static int
+    solverLiteral(SATSolver& satSolver, vector<int>& cnfVarToLit, int lit)
+    {
+      int& v = cnfVarToLit[lit >> 1];
+      if (v < 0)
+        v = 2 * satSolver.newVar();
+      return v ^ (lit & 1);
+    }
+
+    // Adds clauses that make "root" true. The nodes that already have
+    // literals are reused. The rest of root's cone is copied into an AIG of
+    // its own, with those nodes as the inputs, and mapped to CNF like the
+    // first AIG was.
+    void
+    ToSATAIG::addCone(SATSolver& satSolver, Aig_Obj_t* root)
+    {
+      Aig_Man_t* aigMgr = kept->mgr.aigMgr;
+      SATSolver::vec_literals clause;
+
+      // The nodes of the cone are marked with the current traversal ID.
+      Aig_ManIncrementTravId(aigMgr);
+
+      Aig_Obj_t* top = Aig_Regular(root);
+      if (Aig_ObjIsConst1(top))
+        {
+          if (Aig_IsComplement(root))
+            satSolver.addClause(clause);
+          return;
+        }
+
+      Aig_Man_t* cone = Aig_ManStart(0);
+      vector<int> inputLits;
+      vector<Aig_Obj_t*> copied;
+
+      // Depth first, without recursion, because the cones can be deep.
+      vector<Aig_Obj_t*> stack(1, top);
+      while (!stack.empty())
+        {
+          Aig_Obj_t* n = stack.back();
+          if (Aig_ObjIsTravIdCurrent(aigMgr, n))
+            {
+              stack.pop_back();
+              continue;
+            }
+
+          if (Aig_ObjIsConst1(n))
+            n->pData = Aig_ManConst1(cone);
+          else if (nodeToLit[n->Id] >= 0 || Aig_ObjIsPi(n))
+            {
+              // A bit of a symbol that the solver hasn't seen yet.
+              if (nodeToLit[n->Id] < 0)
+                {
+                  const SATSolver::Var v = satSolver.newVar();
+                  satSolver.setFrozen(v);
+                  nodeToLit[n->Id] = v + v;
+                }
+              n->pData = Aig_ObjCreatePi(cone);
+              inputLits.push_back(nodeToLit[n->Id]);
+            }
+          else
+            {
+              if (!Aig_ObjIsTravIdCurrent(aigMgr, Aig_ObjFanin0(n)))
+                {
+                  stack.push_back(Aig_ObjFanin0(n));
+                  continue;
+                }
+              if (!Aig_ObjIsTravIdCurrent(aigMgr, Aig_ObjFanin1(n)))
+                {
+                  stack.push_back(Aig_ObjFanin1(n));
+                  continue;
+                }
+              n->pData = Aig_And(cone, Aig_ObjChild0Copy(n), Aig_ObjChild1Copy(n));
+              copied.push_back(n);
+            }
+          Aig_ObjSetTravIdCurrent(aigMgr, n);
+          stack.pop_back();
+        }
+
+      Aig_ObjCreatePo(cone, Aig_NotCond((Aig_Obj_t*) top->pData, Aig_IsComplement(root)));
+      Aig_ManCleanup(cone);
+
+      Cnf_Dat_t* cnfData;
+      if (!bm->UserFlags.isSet("simple-cnf","0"))
+        cnfData = Cnf_Derive(cone, 0);
+      else
+        cnfData = Cnf_DeriveSimple(cone, 0);
+
+      vector<int> cnfVarToLit(cnfData->nVars, -1);
+      Aig_Obj_t* pObj;
+      int i;
+      Aig_ManForEachPi(cone, pObj, i)
+        if (cnfData->pVarNums[pObj->Id] >= 0)
+          cnfVarToLit[cnfData->pVarNums[pObj->Id]] = inputLits[i];
+
+      bm->GetRunTimes()->start(RunTimes::SendingToSAT);
+      for (i = 0; i < cnfData->nClauses && satSolver.okay(); i++)
+        {
+          clause.clear();
+          for (int* pLit = cnfData->pClauses[i]; pLit < cnfData->pClauses[i + 1]; pLit++)
+            clause.push(Minisat::toLit(solverLiteral(satSolver, cnfVarToLit, *pLit)));
+          satSolver.addClause(clause);
+        }
+      bm->GetRunTimes()->stop(RunTimes::SendingToSAT);
+
+      // So the next cone can use the new nodes too.
+      if (!satSolver.eliminatesVariables())
+        for (i = 0; i < copied.size(); i++)
+          {
+            Aig_Obj_t* c = (Aig_Obj_t*) copied[i]->pData;
+            const int var = cnfData->pVarNums[Aig_Regular(c)->Id];
+            if (var >= 0)
+              nodeToLit[copied[i]->Id] = solverLiteral(satSolver, cnfVarToLit, var + var + Aig_IsComplement(c));
+          }
+
+      Cnf_DataFree(cnfData);
+      Aig_ManStop(cone);
+    }
+
+    // Bit-blasts "input" into the kept AIG, and adds it to the solver.
+    void
+    ToSATAIG::addFormula(SATSolver& satSolver, const ASTNode& input)
+    {
+      BBNodeManagerAIG& mgr = kept->mgr;
+      BitBlaster<BBNodeAIG, BBNodeManagerAIG>& bb = kept->bb;
+
+      bm->GetRunTimes()->start(RunTimes::BitBlasting);
+      BBNodeAIG BBFormula = bb.BBForm(input);
+      bm->GetRunTimes()->stop(RunTimes::BitBlasting);
+      bb.ClearAllTables();
+
+      nodeToLit.resize(Aig_ManObjNumMax(mgr.aigMgr), -1);
+
+      // Bits that were given variables elsewhere, e.g. by the refinement,
+      // keep them.
+      BBNodeManagerAIG::SymbolToBBNode::const_iterator it;
+      for (it = mgr.symbolToBBNode.begin(); it != mgr.symbolToBBNode.end(); it++)
+        {
+          ASTNodeToSATVar::const_iterator v = nodeToSATVar.find(it->first);
+          if (v == nodeToSATVar.end())
+            continue;
+          const vector<BBNodeAIG>& b = it->second;
+          for (unsigned i = 0; i < b.size(); i++)
+            {
+              if (b[i].IsNull() || v->second[i] == ~((unsigned) 0))
+                continue;
+              Aig_Obj_t* pObj = Aig_ManPi(mgr.aigMgr, b[i].symbol_index);
+              nodeToLit[pObj->Id] = v->second[i] + v->second[i];
+            }
+        }
+
+      bm->GetRunTimes()->start(RunTimes::CNFConversion);
+      addCone(satSolver, BBFormula.n);
+      bm->GetRunTimes()->stop(RunTimes::CNFConversion);
+
+      // The bits the counterexample can now be read from. Like the first
+      // CNF, symbols that no added cone has depended on are left out, they
+      // may have been simplified away, and their values come from the
+      // substitutions instead.
+      for (it = mgr.symbolToBBNode.begin(); it != mgr.symbolToBBNode.end(); it++)
+        {
+          const vector<BBNodeAIG>& b = it->second;
+          ASTNodeToSATVar::iterator v = nodeToSATVar.find(it->first);
+          if (v == nodeToSATVar.end())
+            {
+              bool used = false;
+              for (unsigned i = 0; i < b.size() && !used; i++)
+                used = !b[i].IsNull() && Aig_ObjIsTravIdCurrent(mgr.aigMgr, Aig_ManPi(mgr.aigMgr, b[i].symbol_index));
+              if (!used)
+                continue;
+            }
+          for (unsigned i = 0; i < b.size(); i++)
+            {
+              if (b[i].IsNull())
+                continue;
+              const int lit = nodeToLit[Aig_ManPi(mgr.aigMgr, b[i].symbol_index)->Id];
+              if (lit < 0)
+                continue;
+              if (v == nodeToSATVar.end())
+                v = nodeToSATVar.insert(make_pair(it->first, vector<unsigned>(b.size(), ~((unsigned) 0)))).first;
+              v->second[i] = lit >> 1;
+            }
+        }
+    }
+
     ToSATAIG::~ToSATAIG()
     {
     	ClearAllTables();
@@ -10,6 +10,7 @@
 #ifndef TOSATAIG_H
 #define TOSATAIG_H
 #include <cmath>
+#include <memory>
 
 #include "../../AST/AST.h"
 #include "../../AST/RunTimes.h"
@@ -21,6 +22,31 @@
 
 namespace BEEV
 {
+  class Simplifier;
+
+  // TopLevelSTPAux bit-blasts for the bit-blasting simplification, to check
+  // whether simplifying made the AIG bigger, and to make the CNF. It keeps one
+  // of these for all three, so each only blasts what the earlier ones didn't.
+  // It has its own simplifier, which has no substitutions, so the memo tables
+  // stay right whatever happens to the substitution map.
+  class SharedBitBlast : boost::noncopyable
+  {
+    Simplifier* simp;
+
+  public:
+    BBNodeManagerAIG mgr;
+    BitBlaster<BBNodeAIG, BBNodeManagerAIG> bb;
+
+    SharedBitBlast(STPMgr * bm);
+    ~SharedBitBlast();
+
+    // The number of AIG nodes that "n" depends on.
+    int
+    size(const BBNodeAIG& n)
+    {
+      return Aig_DagSize(n.n);
+    }
+  };
 
   class ToSATAIG : public ToSATBase
   {
@@ -29,6 +55,9 @@ namespace BEEV
     ASTNodeToSATVar nodeToSATVar;
     simplifier::constantBitP::ConstantBitPropagation* cb;
 
+    // If not NULL, what's been bit-blasted already.
+    SharedBitBlast* shared;
+
     ArrayTransformer *arrayTransformer;
 
     // don't assign or copy construct.
@@ -40,13 +69,26 @@ namespace BEEV
 
 	ToCNFAIG toCNF;
 
+    // If the first call might be followed by formulas to add, the AIG it
+    // made is kept here, with the solver literal of each AIG node that has
+    // one (-1 if not), by node Id.
+    std::auto_ptr<SharedBitBlast> own;
+    SharedBitBlast* kept;
+    vector<int> nodeToLit;
+
     void init()
     {
         count = 0;
         first = true;
+        kept = NULL;
     }
 
-    static int cnf_calls;
+    void keepLiterals(SATSolver& satSolver, Cnf_Dat_t* cnfData);
+    void addFormula(SATSolver& satSolver, const ASTNode& input);
+    void addCone(SATSolver& satSolver, Aig_Obj_t* root);
+
+    // Per thread, like ABC's CNF manager that it decides whether to keep.
+    static __thread int cnf_calls;
 
   public:
     bool cbIsDestructed()
@@ -58,14 +100,17 @@ namespace BEEV
       ToSATBase(bm), toCNF(bm->UserFlags)
     {
       cb = NULL;
+      shared = NULL;
       init();
       arrayTransformer = at;
     }
 
-    ToSATAIG(STPMgr * bm, simplifier::constantBitP::ConstantBitPropagation* cb_, ArrayTransformer *at ) :
+    ToSATAIG(STPMgr * bm, simplifier::constantBitP::ConstantBitPropagation* cb_, ArrayTransformer *at,
+        SharedBitBlast* shared_ = NULL) :
     	ToSATBase(bm), cb(cb_), toCNF(bm->UserFlags)
     {
       cb = cb_;
+      shared = shared_;
       init();
       arrayTransformer = at;
     }
@@ -87,6 +132,11 @@ namespace BEEV
 
     bool  CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef);
 
+    bool canAddFormulas()
+    {
+      return kept != NULL;
+    }
+
   };
 }
 
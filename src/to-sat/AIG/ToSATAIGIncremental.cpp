@@ -0,0 +1,134 @@
+#include "ToSATAIGIncremental.h"
+#include "../BitBlaster.h"
+#include "../../simplifier/simplifier.h"
+
+namespace BEEV
+{
+  SATSolver::Var
+  ToSATAIGIncremental::newActivation(SATSolver& satSolver)
+  {
+    SATSolver::Var v = satSolver.newVar();
+    satSolver.setFrozen(v);
+    return v;
+  }
+
+  void
+  ToSATAIGIncremental::retire(SATSolver& satSolver, SATSolver::Var activation)
+  {
+    SATSolver::vec_literals clause;
+    clause.push(SATSolver::mkLit(activation, true));
+    satSolver.addClause(clause);
+  }
+
+  void
+  ToSATAIGIncremental::addGuarded(SATSolver& satSolver, const ASTNode& input, SATSolver::Var activation)
+  {
+    if (input == ASTTrue)
+      return;
+
+    if (input == ASTFalse)
+      {
+        retire(satSolver, activation);
+        return;
+      }
+
+    Simplifier simp(bm);
+
+    BBNodeManagerAIG mgr;
+    BitBlaster<BBNodeAIG, BBNodeManagerAIG> bb(&mgr, &simp, bm->defaultNodeFactory, &bm->UserFlags);
+
+    bm->GetRunTimes()->start(RunTimes::BitBlasting);
+    BBNodeAIG BBFormula = bb.BBForm(input);
+    bm->GetRunTimes()->stop(RunTimes::BitBlasting);
+
+    bm->GetRunTimes()->start(RunTimes::CNFConversion);
+    Cnf_Dat_t* cnfData = NULL;
+    ASTNodeToSATVar cnfVars;
+    toCNF.toCNF(BBFormula, cnfData, cnfVars, false, mgr);
+    bm->GetRunTimes()->stop(RunTimes::CNFConversion);
+
+    // Free the memory in the AIGs.
+    BBFormula = BBNodeAIG(); // null node
+    mgr.stop();
+
+    bm->GetRunTimes()->start(RunTimes::SendingToSAT);
+
+    // The bits of symbols are mapped onto the variables they were given last
+    // time. Everything else gets a new variable.
+    vector<SATSolver::Var> cnfToSolver(cnfData->nVars, -1);
+    for (ASTNodeToSATVar::const_iterator it = cnfVars.begin(); it != cnfVars.end(); it++)
+      {
+        const vector<unsigned>& local = it->second;
+        vector<unsigned>& global = nodeToSATVar[it->first];
+        if (global.empty())
+          global.resize(local.size(), ~((unsigned) 0));
+        assert(global.size() == local.size());
+
+        for (int i = 0; i < local.size(); i++)
+          {
+            if (local[i] == ~((unsigned) 0))
+              continue;
+
+            if (global[i] == ~((unsigned) 0))
+              {
+                global[i] = satSolver.newVar();
+                satSolver.setFrozen(global[i]);
+              }
+            cnfToSolver[local[i]] = global[i];
+          }
+      }
+
+    for (int i = 0; i < cnfData->nVars; i++)
+      if (cnfToSolver[i] == -1)
+        cnfToSolver[i] = satSolver.newVar();
+
+    // With a single output and no extra output variables, the last clause
+    // asserts the output. The others just define the fresh variables.
+    SATSolver::vec_literals satSolverClause;
+    for (int i = 0; i < cnfData->nClauses; i++)
+      {
+        satSolverClause.clear();
+        for (int * pLit = cnfData->pClauses[i], *pStop = cnfData->pClauses[i
+            + 1]; pLit < pStop; pLit++)
+          {
+            SATSolver::Var var = cnfToSolver[(*pLit) >> 1];
+            satSolverClause.push(SATSolver::mkLit(var, (*pLit) & 1));
+          }
+
+        if (i == cnfData->nClauses - 1)
+          satSolverClause.push(SATSolver::mkLit(activation, true));
+
+        satSolver.addClause(satSolverClause);
+      }
+    bm->GetRunTimes()->stop(RunTimes::SendingToSAT);
+
+    Cnf_DataFree(cnfData);
+    cnfData = NULL;
+  }
+
+  bool
+  ToSATAIGIncremental::CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef)
+  {
+    assert(!needAbsRef);
+
+    if (lastQuery != -1)
+      retire(satSolver, lastQuery);
+
+    lastQuery = newActivation(satSolver);
+    addGuarded(satSolver, input, lastQuery);
+
+    SATSolver::vec_literals assumps;
+    for (int i = 0; i < assumptions.size(); i++)
+      assumps.push(SATSolver::mkLit(assumptions[i], false));
+    assumps.push(SATSolver::mkLit(lastQuery, false));
+
+    bm->GetRunTimes()->start(RunTimes::Solving);
+    const bool result = satSolver.solve(assumps);
+    bm->GetRunTimes()->stop(RunTimes::Solving);
+
+    if (bm->UserFlags.stats_flag)
+      satSolver.printStats();
+
+    return result;
+  }
+}
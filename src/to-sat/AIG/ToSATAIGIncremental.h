@@ -0,0 +1,76 @@
+#ifndef TOSATAIGINCREMENTAL_H
+#define TOSATAIGINCREMENTAL_H
+
+#include "../../AST/AST.h"
+#include "../../STPManager/STPManager.h"
+#include "../../sat/SATSolver.h"
+#include "ToCNFAIG.h"
+
+namespace BEEV
+{
+  // Sends formulas to a SAT solver that lives across many queries. Each
+  // formula is bit-blasted and converted to CNF on its own. The Tseitin
+  // variables are fresh each time, so only the clause asserting the output
+  // is guarded by an activation literal. Symbols keep the same SAT variables
+  // for the life of the solver.
+  class ToSATAIGIncremental : public ToSATBase
+  {
+  private:
+
+    // Every symbol that has been sent to the solver. Never cleared.
+    ASTNodeToSATVar nodeToSATVar;
+
+    ToCNFAIG toCNF;
+
+    // Activation literals of the assertion levels, assumed on each solve.
+    vector<SATSolver::Var> assumptions;
+
+    // The activation literal of the last query. It's retired before the next.
+    SATSolver::Var lastQuery;
+
+    // don't assign or copy construct.
+    ToSATAIGIncremental&  operator = (const ToSATAIGIncremental& other);
+    ToSATAIGIncremental(const ToSATAIGIncremental& other);
+
+  public:
+
+    ToSATAIGIncremental(STPMgr * bm) :
+      ToSATBase(bm), toCNF(bm->UserFlags)
+    {
+      lastQuery = -1;
+    }
+
+    // Returns a new, frozen, activation variable.
+    SATSolver::Var newActivation(SATSolver& satSolver);
+
+    // Adds clauses to the solver such that "activation" implies "input".
+    void addGuarded(SATSolver& satSolver, const ASTNode& input, SATSolver::Var activation);
+
+    // Permanently disables everything guarded by "activation".
+    void retire(SATSolver& satSolver, SATSolver::Var activation);
+
+    void setAssumptions(const vector<SATSolver::Var>& a)
+    {
+      assumptions = a;
+    }
+
+    // The clauses stay in the solver, so the map must too.
+    void
+    ClearAllTables()
+    {
+    }
+
+    // Used to read out the satisfiable answer.
+    ASTNodeToSATVar&
+    SATVar_to_SymbolIndexMap()
+    {
+      return nodeToSATVar;
+    }
+
+    // Encodes input under a fresh activation literal, then solves assuming
+    // it and the assertion levels. Returns the result of the solve.
+    bool  CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef);
+  };
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "XorAIG.h"
+
+namespace BEEV
+{
+  Aig_Man_t*
+  extractXors(Aig_Man_t* p, std::vector<std::vector<Aig_Obj_t*> >& xors, int& extraPos)
+  {
+    Aig_Obj_t* o;
+    int i;
+
+    // An XOR is three AND nodes. It's only taken if the two beneath the
+    // top belong to it alone, otherwise they'd be needed anyway. Those two
+    // might look like XORs themselves, so the XORs are found from the top
+    // down, and the nodes beneath one that's taken are left alone. The
+    // fanins of a node have smaller Ids.
+    std::vector<Aig_Obj_t*> fanin0(Aig_ManObjNumMax(p), (Aig_Obj_t*) NULL);
+    std::vector<Aig_Obj_t*> fanin1(Aig_ManObjNumMax(p), (Aig_Obj_t*) NULL);
+    std::vector<bool> inner(Aig_ManObjNumMax(p), false);
+    std::vector<int> xorUses(Aig_ManObjNumMax(p), 0);
+    for (i = Aig_ManObjNumMax(p) - 1; i >= 0; i--)
+      {
+        o = Aig_ManObj(p, i);
+        Aig_Obj_t* a;
+        Aig_Obj_t* b;
+        if (o == NULL || !Aig_ObjIsNode(o) || inner[o->Id] || !Aig_ObjRecognizeExor(o, &a, &b)
+            || Aig_ObjRefs(Aig_ObjFanin0(o)) != 1 || Aig_ObjRefs(Aig_ObjFanin1(o)) != 1)
+          continue;
+        fanin0[o->Id] = a;
+        fanin1[o->Id] = b;
+        inner[Aig_ObjFanin0(o)->Id] = true;
+        inner[Aig_ObjFanin1(o)->Id] = true;
+        xorUses[Aig_Regular(a)->Id]++;
+        xorUses[Aig_Regular(b)->Id]++;
+      }
+
+    // An XOR that's only used by one other XOR is part of its chain. Both of
+    // the other's lower nodes refer to it.
+    std::vector<bool> absorbed(Aig_ManObjNumMax(p), false);
+    Aig_ManForEachNode(p, o, i)
+      absorbed[o->Id] = fanin0[o->Id] != NULL && xorUses[o->Id] == 1 && Aig_ObjRefs(o) == 2;
+
+    Aig_Man_t* pNew = Aig_ManStart(Aig_ManObjNumMax(p));
+    Aig_ManCleanData(p);
+    Aig_ManConst1(p)->pData = Aig_ManConst1(pNew);
+    Aig_ManForEachPi(p, o, i)
+      o->pData = Aig_ObjCreatePi(pNew);
+
+    const int first = xors.size();
+    Vec_Ptr_t* vNodes = Aig_ManDfs(p);
+    Vec_PtrForEachEntry(vNodes, o, i)
+      {
+        if (inner[o->Id] || absorbed[o->Id])
+          continue;
+        if (fanin0[o->Id] == NULL)
+          {
+            o->pData = Aig_And(pNew, Aig_ObjChild0Copy(o), Aig_ObjChild1Copy(o));
+            continue;
+          }
+
+        o->pData = Aig_ObjCreatePi(pNew);
+        xors.push_back(std::vector<Aig_Obj_t*>(1, (Aig_Obj_t*) o->pData));
+        std::vector<Aig_Obj_t*>& x = xors.back();
+
+        // The complements of the chain's XORs are put on the first leaf.
+        bool complement = false;
+        std::vector<Aig_Obj_t*> stack;
+        stack.push_back(fanin0[o->Id]);
+        stack.push_back(fanin1[o->Id]);
+        while (!stack.empty())
+          {
+            Aig_Obj_t* c = stack.back();
+            stack.pop_back();
+            Aig_Obj_t* r = Aig_Regular(c);
+            complement ^= Aig_IsComplement(c);
+            if (absorbed[r->Id])
+              {
+                stack.push_back(fanin0[r->Id]);
+                stack.push_back(fanin1[r->Id]);
+              }
+            else
+              x.push_back((Aig_Obj_t*) r->pData);
+          }
+        x[1] = Aig_NotCond(x[1], complement);
+      }
+    Vec_PtrFree(vNodes);
+
+    Aig_ManForEachPo(p, o, i)
+      Aig_ObjCreatePo(pNew, Aig_ObjChild0Copy(o));
+
+    // Each object that's in an XOR drives one PO, so a node gets a CNF
+    // variable, and a PI has a reference, which says that it's used.
+    extraPos = 0;
+    Aig_ManIncrementTravId(pNew);
+    for (unsigned j = first; j < xors.size(); j++)
+      for (unsigned k = 1; k < xors[j].size(); k++)
+        {
+          Aig_Obj_t* r = Aig_Regular(xors[j][k]);
+          if (Aig_ObjIsConst1(r) || Aig_ObjIsTravIdCurrent(pNew, r))
+            continue;
+          Aig_ObjSetTravIdCurrent(pNew, r);
+          Aig_ObjCreatePo(pNew, r);
+          extraPos++;
+        }
+
+    Aig_ManCleanup(pNew);
+    return pNew;
+  }
+}
@@ -0,0 +1,20 @@
+#ifndef XORAIG_H_
+#define XORAIG_H_
+
+#include "../../extlib-abc/aig.h"
+#include <vector>
+
+namespace BEEV {
+
+// Finds the XORs of the AIG, which the bit-blaster makes for bvxor and the
+// adders, and follows each through the XORs that only it uses, so chains
+// like a^b^c^d are taken whole. Returns a copy in which each chain is a new
+// PI, and adds to "xors" the objects of the copy that say what the PI is:
+// the first object is the PI, and it equals the XOR of the others. The
+// others drive extra POs after the originals, so that they get CNF
+// variables and references, "extraPos" is how many. The original PIs and
+// POs are kept in order. The caller stops the original.
+Aig_Man_t* extractXors(Aig_Man_t* p, std::vector<std::vector<Aig_Obj_t*> >& xors, int& extraPos);
+
+}
+#endif /* XORAIG_H_ */
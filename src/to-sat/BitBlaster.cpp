@@ -38,7 +38,7 @@ namespace BEEV
   using simplifier::constantBitP::NodeToFixedBitsMap;
 
 #define BBNodeVec vector<BBNode>
-#define BBNodeVecMap map<ASTNode, vector<BBNode> >
+#define BBNodeVecMap NodeAttribute<vector<BBNode> >
 #define BBNodeSet set<BBNode>
 
   vector<BBNodeAIG> _empty_BBNodeAIGVec;
@@ -92,18 +92,18 @@ namespace BEEV
 // Look through the maps to see what the bitblaster has discovered (if anything) is constant.
 // then looks through for AIGS that are mapped to from different ASTNodes.
   template<class BBNode, class BBNodeManagerT>
-    void
+    const BBNode
     BitBlaster<BBNode, BBNodeManagerT>::getConsts(const ASTNode& form, ASTNodeMap& fromTo, ASTNodeMap& equivs)
     {
       assert(form.GetType() == BOOLEAN_TYPE);
 
       BBNodeSet support;
-      BBForm(form, support);
+      const BBNode result = BBForm(form, support);
 
       assert(support.size() ==0);
 
         {
-        typename map<ASTNode, BBNode>::iterator it;
+        typename NodeAttribute<BBNode>::iterator it;
         for (it = BBFormMemo.begin(); it != BBFormMemo.end(); it++)
           {
           const ASTNode& n = it->first;
@@ -170,7 +170,7 @@ namespace BEEV
       if (form.GetSTPMgr()->UserFlags.isSet("bb-equiv","1"))
       {
         HASHMAP <intptr_t ,ASTNode> nodeToFn;
-        typename map<ASTNode, BBNode>::iterator it;
+        typename NodeAttribute<BBNode>::iterator it;
         for (it = BBFormMemo.begin(); it != BBFormMemo.end(); it++)
           {
           const ASTNode& n = it->first;
@@ -206,7 +206,7 @@ namespace BEEV
       if (form.GetSTPMgr()->UserFlags.isSet("bb-equiv","1"))
         {
           M lookup;
-          typename std::map<ASTNode, vector<BBNode> >::iterator it;
+          typename BBNodeVecMap::iterator it;
           for (it = BBTermMemo.begin(); it != BBTermMemo.end(); it++)
             {
               const ASTNode& n = it->first;
@@ -245,6 +245,7 @@ namespace BEEV
                 }
             }
         }
+      return result;
     }
 
 
@@ -1013,10 +1014,11 @@ namespace BEEV
     const BBNode
     BitBlaster<BBNode, BBNodeManagerT>::BBForm(const ASTNode& form, BBNodeSet& support)
     {
-      typename map<ASTNode, BBNode>::iterator it = BBFormMemo.find(form);
+      typename NodeAttribute<BBNode>::iterator it = BBFormMemo.find(form);
       if (it != BBFormMemo.end())
         {
-        // already there.  Just return it.
+        // Constant bit propagation may have updated something.
+        updateForm(form, it->second, support);
         return it->second;
         }
 
@@ -1882,6 +1884,32 @@ namespace BEEV
     }
 
 
+// Picks the multiplication variant for the "auto" setting, from the bits
+// of the operands that are known. If one operand is a constant, Booth
+// recoding leaves few partial products, and they're added with the plain
+// addition network. Products that are truncated to the width, and aren't
+// too wide, are added with a tree of adders (v13). The rest use v7, on
+// products that can't overflow, and on very wide ones, v13 was bigger and
+// slower. The choices come from scripts/mult-variants.sh.
+  template<class BBNode, class BBNodeManagerT>
+    string
+    BitBlaster<BBNode, BBNodeManagerT>::chooseMultiplicationVariant(const BBNodeVec& x, const BBNodeVec& y)
+    {
+      const int bitWidth = x.size();
+      if (isConstant(x) || isConstant(y))
+        return "3";
+
+      int highestX = bitWidth - 1;
+      while (highestX > 0 && x[highestX] == BBFalse)
+        highestX--;
+      int highestY = bitWidth - 1;
+      while (highestY > 0 && y[highestY] == BBFalse)
+        highestY--;
+
+      const bool truncated = (highestX + highestY >= bitWidth);
+      return (truncated && bitWidth <= multiplication_auto_width) ? "13" : "7";
+    }
+
 // Multiply two bitblasted numbers
   template<class BBNode, class BBNodeManagerT>
     BBNodeVec
@@ -1907,20 +1935,23 @@ namespace BEEV
 
       std::vector<list<BBNode> > products(bitWidth+1); // Create one extra to avoid special cases.
 
-      if (multiplication_variant == "1")
+      const string variant =
+          (multiplication_variant == "auto") ? chooseMultiplicationVariant(x, y) : multiplication_variant;
+
+      if (variant == "1")
         {
         return mult_normal(x, y, support, n);
         }
       //else if (multiplication_variant == "2")
         // V2 used to be V3 with normal rather than booth recoding.
         // To recreate V2, use V3 and turn off Booth recoding.
-      else if (multiplication_variant == "3")
+      else if (variant == "3")
         {
         mult_Booth(_x, _y, support, n[0], n[1], products, n);
         setColumnsToZero(products,support,n);
         return buildAdditionNetworkResult(products, support, n);
         }
-      else if (multiplication_variant == "4")
+      else if (variant == "4")
         {
         //cerr << "v4";
         mult_Booth(_x, _y, support, n[0], n[1], products, n);
@@ -1935,7 +1966,7 @@ namespace BEEV
           }
         return buildAdditionNetworkResult(products, support, n);
         }
-      else if (multiplication_variant == "5")
+      else if (variant == "5")
               {
               if (!statsFound(n) || !upper_multiplication_bound)
                 {
@@ -1949,31 +1980,31 @@ namespace BEEV
         setColumnsToZero(products,support,n);
         return multWithBounds(n, products, support);
         }
-      else if (multiplication_variant == "6")
+      else if (variant == "6")
         {
           mult_Booth(_x, _y, support,n[0],n[1],products,n);
           setColumnsToZero(products,support,n);
           return v6(products, support, n);
         }
-      else if (multiplication_variant == "7")
+      else if (variant == "7")
         {
         mult_Booth(_x, _y, support, n[0], n[1], products,n);
         setColumnsToZero(products,support,n);
         return v7(products, support, n);
         }
-      else if (multiplication_variant == "8")
+      else if (variant == "8")
         {
         mult_Booth(_x, _y, support, n[0], n[1], products,n);
         setColumnsToZero(products,support,n);
         return v8(products, support, n);
         }
-      else if (multiplication_variant == "9")
+      else if (variant == "9")
         {
         mult_Booth(_x, _y, support, n[0], n[1], products,n);
         setColumnsToZero(products,support,n);
         return v9(products, support,n);
         }
-      else if (multiplication_variant == "13")
+      else if (variant == "13")
         {
         mult_Booth(_x, _y, support, n[0], n[1], products,n);
         setColumnsToZero(products,support,n);
@@ -1981,7 +2012,7 @@ namespace BEEV
         }
       else
         {
-        cerr << "Unk variant" << multiplication_variant;
+        cerr << "Unk variant" << variant;
         FatalError("sda44f");
         }
 
@@ -14,6 +14,7 @@
 #include <cassert>
 #include <map>
 #include "../STPManager/STPManager.h"
+#include "../AST/NodeAttribute.h"
 #include "../boost/noncopyable.hpp"
 #include <list>
 #include "../simplifier/constantBitP/MultiplicationStats.h"
@@ -48,12 +49,12 @@ namespace BEEV
       // Memo table for bit blasted terms.  If a node has already been
       // bitblasted, it is mapped to a vector of Boolean formulas for
       // the
-      std::map<ASTNode, vector<BBNode> > BBTermMemo;
+      NodeAttribute<vector<BBNode> > BBTermMemo;
 
       // Memo table for bit blasted formulas.  If a node has already
       // been bitblasted, it is mapped to a node representing the
       // bitblasted equivalent
-      map<ASTNode, BBNode> BBFormMemo;
+      NodeAttribute<BBNode> BBFormMemo;
 
       /****************************************************************
        * Private Member Functions                                     *
@@ -83,6 +84,8 @@ namespace BEEV
       // Multiply.
       vector<BBNode>
       BBMult(const vector<BBNode>& x, const vector<BBNode>& y, set<BBNode>& support, const ASTNode& n);
+      string
+      chooseMultiplicationVariant(const vector<BBNode>& x, const vector<BBNode>& y);
       void
       mult_allPairs(const vector<BBNode>& x, const vector<BBNode>& y, set<BBNode>& support, vector<list<BBNode> >& products);
       void
@@ -235,6 +238,10 @@ namespace BEEV
 
       const string multiplication_variant;
 
+      // With the "auto" variant, the widest product that's added with a tree
+      // of adders.
+      const int multiplication_auto_width;
+
       ASTNodeSet booth_recoded; // Nodes that have been recoded.
 
     public:
@@ -259,6 +266,7 @@ namespace BEEV
           division_variant_3("1" == _uf->get("division_variant_3", "1")),
 
           multiplication_variant(_uf->get("multiplication_variant", "7")),
+          multiplication_auto_width(atoi(_uf->get("multiplication_auto_width", "256").c_str())),
           upper_multiplication_bound("1" == _uf->get("upper_multiplication_bound", "0")),
 
           adder_variant("1" == _uf->get("adder_variant", "1")),
@@ -291,7 +299,8 @@ namespace BEEV
       const BBNode
       BBForm(const ASTNode& form);
 
-      void
+      // Returns the bit-blasted formula.
+      const BBNode
       getConsts(const ASTNode& n, ASTNodeMap& fromTo, ASTNodeMap& equivs);
 
     };
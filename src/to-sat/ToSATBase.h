@@ -41,6 +41,13 @@ namespace BEEV
     // Bitblasts, CNF conversion and calls toSATandSolve()
     virtual bool CallSAT(SATSolver& SatSolver, const ASTNode& input, bool doesAbsRef) =0;
 
+    // Whether later calls to CallSAT can add formulas other than ASTTrue to
+    // what's already in the solver.
+    virtual bool canAddFormulas()
+    {
+      return false;
+    }
+
     virtual ASTNodeToSATVar& SATVar_to_SymbolIndexMap()= 0;
 
     virtual void ClearAllTables(void)  =0;
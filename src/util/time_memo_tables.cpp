@@ -0,0 +1,110 @@
+// Compares the memo tables keyed on nodes: std::map, ASTNodeMap (hash_map)
+// and NodeAttribute. Each table maps every node of the parsed formula to
+// itself, then every node is looked up several times.
+//
+// Usage: time_memo_tables file.smt2
+
+#include <malloc.h>
+#include "../AST/AST.h"
+#include "../AST/NodeAttribute.h"
+#include "../STPManager/STPManager.h"
+#include "../STPManager/STP.h"
+#include "../cpp_interface/cpp_interface.h"
+#include "StopWatch.h"
+
+using namespace BEEV;
+
+const int lookups = 20;
+
+void
+collect(const ASTNode& n, ASTNodeSet& visited, ASTVec& nodes)
+{
+  if (!visited.insert(n).second)
+    return;
+  for (int i = 0; i < n.Degree(); i++)
+    collect(n[i], visited, nodes);
+  nodes.push_back(n);
+}
+
+size_t
+allocated()
+{
+  return mallinfo().uordblks;
+}
+
+template<class Table>
+  void
+  run(const char * name, const ASTVec& nodes)
+  {
+    const size_t before = allocated();
+    Table* table = new Table;
+
+    Stopwatch2 fill;
+    fill.start();
+    for (int i = 0; i < nodes.size(); i++)
+      (*table)[nodes[i]] = nodes[i];
+    fill.stop();
+
+    const size_t bytes = allocated() - before;
+
+    Stopwatch2 look;
+    look.start();
+    int found = 0;
+    for (int j = 0; j < lookups; j++)
+      for (int i = 0; i < nodes.size(); i++)
+        if (table->find(nodes[i]) != table->end())
+          found++;
+    look.stop();
+
+    assert(found == lookups * nodes.size());
+    delete table;
+
+    cout << name << "\t" << (float(fill.elapsed) / CLOCKS_PER_SEC) << "s fill\t"
+        << (float(look.elapsed) / CLOCKS_PER_SEC) << "s lookup\t" << bytes / 1024 << "KB" << endl;
+  }
+
+int
+main(int argc, char ** argv)
+{
+  extern int
+  smt2parse();
+  extern int
+  smt2lex_destroy(void);
+  extern FILE *smt2in;
+
+  if (argc != 2)
+    {
+      cerr << "Usage: " << argv[0] << " file.smt2" << endl;
+      return 1;
+    }
+
+  STPMgr* mgr = new STPMgr;
+  Cpp_interface interface(*mgr, mgr->defaultNodeFactory);
+  interface.startup();
+  interface.ignoreCheckSat();
+  BEEV::parserInterface = &interface;
+  BEEV::ParserBM = mgr;
+
+  smt2in = fopen(argv[1], "r");
+  if (smt2in == NULL)
+    {
+      cerr << "Can't open " << argv[1] << endl;
+      return 1;
+    }
+  smt2parse();
+  smt2lex_destroy();
+
+  ASTVec nodes;
+  ASTNodeSet visited;
+  ASTVec asserts = interface.GetAsserts();
+  for (int i = 0; i < asserts.size(); i++)
+    collect(asserts[i], visited, nodes);
+  visited.clear();
+
+  cout << nodes.size() << " nodes, " << lookups << " lookups of each" << endl;
+
+  run<map<ASTNode, ASTNode> > ("map", nodes);
+  run<ASTNodeMap> ("hash_map", nodes);
+  run<NodeAttribute<ASTNode> > ("dense", nodes);
+  return 0;
+}
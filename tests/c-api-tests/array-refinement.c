@@ -0,0 +1,53 @@
+/* g++ -I$(HOME)/stp/c_interface array-refinement.c -L$(HOME)/lib -lstp -o cc*/
+
+#include <stdio.h>
+#include <assert.h>
+#include "c_interface.h"
+
+// Different values are read from an array at twelve indices, the first
+// three of which are below "bound". Only the array axioms that the
+// refinement adds after the first solve can show there's no room for them
+// when the bound is two. Each solver that refines is tried.
+int solve(enum ifaceflag_t solver, int bound)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, solver, 0);
+  vc_setFlags(vc,'n');
+  vc_setFlags(vc,'d');
+
+  Type bv8 = vc_bvType(vc, 8);
+  Expr a = vc_varExpr(vc, "a", vc_arrayType(vc, bv8, bv8));
+
+  int n, m;
+  Expr index[12];
+  for (n = 0; n < 12; n++)
+    {
+      char name[8];
+      sprintf(name, "i%d", n);
+      index[n] = vc_varExpr(vc, name, bv8);
+      if (n < 3)
+        vc_assertFormula(vc, vc_bvLtExpr(vc, index[n], vc_bvConstExprFromInt(vc, 8, bound)));
+      vc_assertFormula(vc, vc_eqExpr(vc, vc_readExpr(vc, a, index[n]), vc_bvConstExprFromInt(vc, 8, n + 1)));
+    }
+
+  int result = vc_query(vc, vc_falseExpr(vc));
+  printf("query = %d\n", result);
+  if (result == 0)
+    for (n = 0; n < 12; n++)
+      for (m = n + 1; m < 12; m++)
+        assert(getBVUnsigned(vc_getCounterExample(vc, index[n])) != getBVUnsigned(vc_getCounterExample(vc, index[m])));
+
+  vc_Destroy(vc);
+  return result;
+}
+
+int main() {
+  enum ifaceflag_t solvers[3] = { MS, SMS, CMS2 };
+  int s;
+  for (s = 0; s < 3; s++)
+    {
+      assert(solve(solvers[s], 2) == 1);
+      assert(solve(solvers[s], 3) == 0);
+    }
+  return 0;
+}
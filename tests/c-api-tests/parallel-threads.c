@@ -0,0 +1,109 @@
+/* g++ -I$(HOME)/stp/c_interface parallel-threads.c -L$(HOME)/lib -lstp -pthread -o cc*/
+
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include "c_interface.h"
+
+// Each thread has its own VC, and they all solve at the same time.
+#define THREADS 8
+#define ROUNDS 5
+
+// a*b = 33 has a model, and with a < 16 the model is checked.
+static int multiply(VC vc, int round)
+{
+  Type bv8 = vc_bvType(vc, 8);
+  Expr a = vc_varExpr(vc, "a", bv8);
+  Expr b = vc_varExpr(vc, "b", bv8);
+  Expr c = vc_bvConstExprFromInt(vc, 8, 33 + 2 * round);
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_bvLtExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 16)));
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 8, a, b), c));
+  if (vc_query(vc, vc_falseExpr(vc)) != 0)
+    return 1;
+
+  unsigned ca = getBVUnsigned(vc_getCounterExample(vc, a));
+  unsigned cb = getBVUnsigned(vc_getCounterExample(vc, b));
+  vc_pop(vc);
+
+  if (ca >= 16 || ((ca * cb) & 0xff) != 33 + 2 * round)
+    return 1;
+  return 0;
+}
+
+// Reading back what was just written is valid.
+static int array(VC vc)
+{
+  Type bv32 = vc_bv32Type(vc);
+  Type arr = vc_arrayType(vc, bv32, bv32);
+  Expr A = vc_varExpr(vc, "A", arr);
+  Expr i = vc_varExpr(vc, "i", bv32);
+  Expr j = vc_varExpr(vc, "j", bv32);
+  Expr v = vc_varExpr(vc, "v", bv32);
+
+  Expr written = vc_writeExpr(vc, A, i, v);
+  if (vc_query(vc, vc_eqExpr(vc, vc_readExpr(vc, written, i), v)) != 1)
+    return 1;
+
+  // But a different index needn't be.
+  if (vc_query(vc, vc_eqExpr(vc, vc_readExpr(vc, written, j), v)) != 0)
+    return 1;
+  return 0;
+}
+
+// x*x = 1 doesn't mean x = 1.
+static int squares(VC vc)
+{
+  Type bv16 = vc_bvType(vc, 16);
+  Expr x = vc_varExpr(vc, "x", bv16);
+  Expr one = vc_bvConstExprFromInt(vc, 16, 1);
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 16, x, x), one));
+  int result = vc_query(vc, vc_eqExpr(vc, x, one));
+  vc_pop(vc);
+  return result != 0;
+}
+
+static void* solve(void* arg)
+{
+  int* failures = (int*) arg;
+  for (int round = 0; round < ROUNDS; round++)
+    {
+      VC vc = vc_createValidityChecker();
+      vc_setFlags(vc, 'n');
+      vc_setFlags(vc, 'd');
+
+      *failures += multiply(vc, round);
+      *failures += array(vc);
+      *failures += squares(vc);
+
+      vc_Destroy(vc);
+    }
+  return NULL;
+}
+
+int main()
+{
+  pthread_t threads[THREADS];
+  int failures[THREADS];
+
+  for (int i = 0; i < THREADS; i++)
+    {
+      failures[i] = 0;
+      int r = pthread_create(&threads[i], NULL, solve, &failures[i]);
+      assert(r == 0);
+    }
+
+  int total = 0;
+  for (int i = 0; i < THREADS; i++)
+    {
+      pthread_join(threads[i], NULL);
+      total += failures[i];
+    }
+
+  printf("failures = %d\n", total);
+  assert(total == 0);
+  return 0;
+}
@@ -0,0 +1,66 @@
+/* g++ -I$(HOME)/stp/c_interface push-pop-incremental.c -L$(HOME)/lib -lstp -o cc*/
+
+#include <stdio.h>
+#include <assert.h>
+#include "c_interface.h"
+
+// Keeps the SAT solver between queries and checks the answers stay right
+// as assertion levels are pushed and popped.
+int main() {
+  VC vc = vc_createValidityChecker();
+  vc_setFlags(vc,'n');
+  vc_setFlags(vc,'d');
+  vc_setInterfaceFlags(vc, INCREMENTAL, 1);
+
+  Type bv8 = vc_bvType(vc, 8);
+
+  Expr a = vc_varExpr(vc, "a", bv8);
+  Expr b = vc_varExpr(vc, "b", bv8);
+
+  // a < 16
+  vc_assertFormula(vc, vc_bvLtExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 16)));
+
+  // a*b = 33 has a model, so it isn't valid that a*b != 33.
+  vc_push(vc);
+  Expr prod = vc_bvMultExpr(vc, 8, a, b);
+  vc_assertFormula(vc, vc_eqExpr(vc, prod, vc_bvConstExprFromInt(vc, 8, 33)));
+  int query = vc_query(vc, vc_falseExpr(vc));
+  printf("query = %d\n", query);
+  assert(query == 0);
+
+  Expr ca = vc_getCounterExample(vc, a);
+  Expr cb = vc_getCounterExample(vc, b);
+  assert(getBVUnsigned(ca) < 16);
+  assert(((getBVUnsigned(ca) * getBVUnsigned(cb)) & 0xff) == 33);
+
+  // With a = 0 the product is zero.
+  vc_assertFormula(vc, vc_eqExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 0)));
+  query = vc_query(vc, vc_falseExpr(vc));
+  printf("query = %d\n", query);
+  assert(query == 1);
+  vc_pop(vc);
+
+  // Popped, so it's satisfiable again.
+  query = vc_query(vc, vc_falseExpr(vc));
+  printf("query = %d\n", query);
+  assert(query == 0);
+
+  // A different level at the same height.
+  vc_push(vc);
+  vc_assertFormula(vc, vc_eqExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 3)));
+  query = vc_query(vc, vc_eqExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 3)));
+  printf("query = %d\n", query);
+  assert(query == 1);
+
+  query = vc_query(vc, vc_eqExpr(vc, b, vc_bvConstExprFromInt(vc, 8, 3)));
+  printf("query = %d\n", query);
+  assert(query == 0);
+  vc_pop(vc);
+
+  query = vc_query(vc, vc_eqExpr(vc, a, vc_bvConstExprFromInt(vc, 8, 3)));
+  printf("query = %d\n", query);
+  assert(query == 0);
+
+  vc_Destroy(vc);
+  return 0;
+}
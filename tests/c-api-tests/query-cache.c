@@ -0,0 +1,74 @@
+/* g++ -I$(HOME)/stp/c_interface query-cache.c -L$(HOME)/lib -lstp -o cc*/
+
+#include <stdio.h>
+#include <assert.h>
+#include "c_interface.h"
+
+// The answers to the later queries follow from the earlier ones: the same
+// assertions again, a superset of an unsatisfiable set, and a subset of a
+// satisfiable set. The counterexamples must still be right.
+Expr times5(VC vc, Expr x, int v)
+{
+  return vc_eqExpr(vc, vc_bvMultExpr(vc, 8, x, vc_bvConstExprFromInt(vc, 8, 5)), vc_bvConstExprFromInt(vc, 8, v));
+}
+
+int main() {
+  VC vc = vc_createValidityChecker();
+  vc_setFlags(vc,'n');
+  vc_setFlags(vc,'d');
+
+  Type bv8 = vc_bvType(vc, 8);
+
+  Expr a = vc_varExpr(vc, "a", bv8);
+  Expr b = vc_varExpr(vc, "b", bv8);
+  Expr one = vc_bvConstExprFromInt(vc, 8, 1);
+
+  int i, result;
+  for (i = 0; i < 2; i++)
+    {
+      vc_push(vc);
+      vc_assertFormula(vc, times5(vc, a, 35));
+      result = vc_query(vc, vc_falseExpr(vc));
+      printf("query = %d\n", result);
+      assert(result == 0);
+      assert(((getBVUnsigned(vc_getCounterExample(vc, a)) * 5) & 0xff) == 35);
+      vc_pop(vc);
+    }
+
+  // a*5 can't be both.
+  vc_push(vc);
+  vc_assertFormula(vc, times5(vc, a, 35));
+  vc_assertFormula(vc, times5(vc, a, 36));
+  result = vc_query(vc, vc_falseExpr(vc));
+  vc_pop(vc);
+  printf("query = %d\n", result);
+  assert(result == 1);
+
+  vc_push(vc);
+  vc_assertFormula(vc, times5(vc, a, 35));
+  vc_assertFormula(vc, times5(vc, a, 36));
+  vc_assertFormula(vc, vc_eqExpr(vc, b, one));
+  result = vc_query(vc, vc_falseExpr(vc));
+  vc_pop(vc);
+  printf("query = %d\n", result);
+  assert(result == 1);
+
+  vc_push(vc);
+  vc_assertFormula(vc, times5(vc, a, 35));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, one, b));
+  result = vc_query(vc, vc_falseExpr(vc));
+  vc_pop(vc);
+  printf("query = %d\n", result);
+  assert(result == 0);
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_bvLtExpr(vc, one, b));
+  result = vc_query(vc, vc_falseExpr(vc));
+  printf("query = %d\n", result);
+  assert(result == 0);
+  assert(getBVUnsigned(vc_getCounterExample(vc, b)) > 1);
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+  return 0;
+}
@@ -0,0 +1,54 @@
+/* g++ -I$(HOME)/stp/c_interface sliced-queries.c -L$(HOME)/lib -lstp -o cc*/
+
+#include <stdio.h>
+#include <assert.h>
+#include "c_interface.h"
+
+// The assertions about "a" share no variables with those about "b" and "c",
+// so after the first query their model is reused. The counterexample must
+// still satisfy everything.
+int main() {
+  VC vc = vc_createValidityChecker();
+  vc_setFlags(vc,'n');
+  vc_setFlags(vc,'d');
+
+  Type bv8 = vc_bvType(vc, 8);
+
+  Expr a = vc_varExpr(vc, "a", bv8);
+  Expr b = vc_varExpr(vc, "b", bv8);
+  Expr c = vc_varExpr(vc, "c", bv8);
+
+  // a*5 = 35
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 8, a, vc_bvConstExprFromInt(vc, 8, 5)), vc_bvConstExprFromInt(vc, 8, 35)));
+  // b < c
+  vc_assertFormula(vc, vc_bvLtExpr(vc, b, c));
+
+  int i;
+  for (i = 0; i < 3; i++)
+    {
+      // It isn't valid that c is i.
+      Expr query = vc_eqExpr(vc, c, vc_bvConstExprFromInt(vc, 8, i));
+      vc_push(vc);
+      int result = vc_query(vc, query);
+      printf("query = %d\n", result);
+      assert(result == 0);
+
+      unsigned va = getBVUnsigned(vc_getCounterExample(vc, a));
+      unsigned vb = getBVUnsigned(vc_getCounterExample(vc, b));
+      unsigned vcc = getBVUnsigned(vc_getCounterExample(vc, c));
+      assert(((va * 5) & 0xff) == 35);
+      assert(vb < vcc);
+      assert(vcc != i);
+      vc_pop(vc);
+    }
+
+  // Only the part with "b" and "c" is asked about, and it's valid.
+  vc_push(vc);
+  int result = vc_query(vc, vc_bvLtExpr(vc, b, vc_bvConstExprFromInt(vc, 8, 255)));
+  vc_pop(vc);
+  printf("query = %d\n", result);
+  assert(result == 1);
+
+  vc_Destroy(vc);
+  return 0;
+}